@@ -0,0 +1,88 @@
+// Conta alocações C++ por mensagem no send, contra o mock cluster
+// da librdkafka. A librdkafka é C (malloc), então o contador mede apenas
+// o que o wrapper e o callback do usuário alocam.
+//
+// Uso: delivery_alloc_bench [mensagens]
+#include "producer.hpp"
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+const char* kTopic = "bench-topic";
+
+template <typename MakeCallback>
+void run(const char* label, const std::string& brokers, int messages, MakeCallback make_callback) {
+    mykafka::DeliveryOptions delivery;
+    delivery.mode = mykafka::DeliveryMode::EventThread;
+    mykafka::Producer producer(brokers, delivery);
+    const std::string payload(256, 'x');
+
+    // aquece o pool de contextos e o registro de tópicos
+    for (int i = 0; i < 2000; ++i)
+        producer.send(kTopic, payload, make_callback());
+    producer.flush(10000);
+
+    uint64_t before = g_allocs.load();
+    for (int i = 0; i < messages; ++i)
+        producer.send(kTopic, payload, make_callback());
+    producer.flush(10000);
+    uint64_t after = g_allocs.load();
+
+    std::cout << label << ": " << double(after - before) / messages << " alocações/mensagem\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int messages = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    char errstr[512];
+    rd_kafka_t* mock_rk = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr, sizeof(errstr));
+    if (!mock_rk) {
+        std::cerr << "Erro criando handle do mock: " << errstr << std::endl;
+        return 1;
+    }
+    rd_kafka_mock_cluster_t* mcluster = rd_kafka_mock_cluster_new(mock_rk, 1);
+    rd_kafka_mock_topic_create(mcluster, kTopic, 4, 1);
+    const std::string brokers = rd_kafka_mock_cluster_bootstraps(mcluster);
+
+    std::atomic<uint64_t> delivered{0};
+    run("sem callback        ", brokers, messages, []() {
+        return mykafka::Producer::DeliveryCallback();
+    });
+    run("callback sem estado ", brokers, messages, [&delivered]() {
+        return mykafka::Producer::DeliveryCallback([&delivered](const mykafka::DeliveryReport&) {
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    run("callback com 64 bytes", brokers, messages, [&delivered]() {
+        char state[64] = {};
+        return mykafka::Producer::DeliveryCallback([&delivered, state](const mykafka::DeliveryReport&) {
+            delivered.fetch_add(state[0] + 1, std::memory_order_relaxed);
+        });
+    });
+
+    rd_kafka_mock_cluster_destroy(mcluster);
+    rd_kafka_destroy(mock_rk);
+    return 0;
+}
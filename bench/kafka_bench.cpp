@@ -0,0 +1,387 @@
+// Suíte de benchmarks do wrapper contra o mock cluster da librdkafka
+// (test.mock.num.brokers), sem broker real.
+//
+// Varre tamanho da mensagem, tamanho do lote, modo de entrega e número de
+// threads produtoras; depois mede o consumo. Para cada caso reporta msgs/s,
+// MB/s, p50/p99 da latência de entrega e alocações C++ por mensagem, no
+// console e em JSON, para comparar versões antes de atualizar produção.
+//
+// Uso: kafka_bench [mensagens por caso] [saida.json]
+#include "producer.hpp"
+#include "consumer.hpp"
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}
+
+// a librdkafka é C (malloc): o contador mede só o wrapper e o código do bench
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+const char* kProduceTopic = "bench-produce";
+const char* kConsumeTopic = "bench-consume";
+const int kPartitions = 8;
+
+// mensagens enviadas e ainda sem relatório; acima disso o produtor espera
+const uint64_t kWindow = 50000;
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+const char* mode_name(mykafka::DeliveryMode mode) {
+    switch (mode) {
+    case mykafka::DeliveryMode::Inline:      return "inline";
+    case mykafka::DeliveryMode::EventThread: return "event_thread";
+    case mykafka::DeliveryMode::Executor:    return "executor";
+    case mykafka::DeliveryMode::EventLoop:   return "event_loop";
+    }
+    return "?";
+}
+
+struct ProducerCase {
+    size_t size;
+    size_t batch; // 1 = send, >1 = send_batch
+    mykafka::DeliveryMode mode;
+    int threads;
+};
+
+struct ProducerResult {
+    ProducerCase params;
+    uint64_t messages = 0;
+    uint64_t errors = 0;
+    double seconds = 0;
+    double msgs_per_sec = 0;
+    double mb_per_sec = 0;
+    uint64_t p50_us = 0;
+    uint64_t p99_us = 0;
+    double allocs_per_msg = 0;
+};
+
+struct ConsumerResult {
+    size_t size = 0;
+    uint64_t messages = 0;
+    double seconds = 0;
+    double msgs_per_sec = 0;
+    double mb_per_sec = 0;
+    uint64_t p50_us = 0; // processamento: recebimento → fim do callback
+    uint64_t p99_us = 0;
+    double allocs_per_msg = 0;
+};
+
+// Cliente que só hospeda o mock cluster; todos os casos usam os mesmos brokers
+class MockCluster {
+public:
+    explicit MockCluster(int brokers) {
+        char errstr[512];
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        std::string count = std::to_string(brokers);
+        if (rd_kafka_conf_set(conf, "test.mock.num.brokers", count.c_str(),
+                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            rd_kafka_conf_destroy(conf);
+            throw std::runtime_error(errstr);
+        }
+        rk_ = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+        if (!rk_)
+            throw std::runtime_error(std::string("Erro criando handle do mock: ") + errstr);
+        cluster_ = rd_kafka_handle_mock_cluster(rk_);
+    }
+
+    ~MockCluster() { rd_kafka_destroy(rk_); } // o cluster pertence ao handle
+
+    void create_topic(const char* topic, int partitions) {
+        rd_kafka_mock_topic_create(cluster_, topic, partitions, 1);
+    }
+
+    std::string bootstraps() const { return rd_kafka_mock_cluster_bootstraps(cluster_); }
+
+private:
+    rd_kafka_t* rk_ = nullptr;
+    rd_kafka_mock_cluster_t* cluster_ = nullptr;
+};
+
+mykafka::DeliveryOptions delivery_options(mykafka::DeliveryMode mode) {
+    mykafka::DeliveryOptions delivery;
+    delivery.mode = mode;
+    if (mode == mykafka::DeliveryMode::Executor)
+        delivery.executor = [](std::function<void()> task) { task(); };
+    return delivery;
+}
+
+// Segura o produtor enquanto houver mensagens demais sem relatório. 'sent' é
+// uma foto do contador global e 'reported' cresce com as entregas das outras
+// threads: a diferença pode ficar negativa, por isso é com sinal.
+void wait_window(mykafka::Producer& producer, uint64_t sent,
+                 const std::atomic<uint64_t>& reported) {
+    while (static_cast<int64_t>(sent) - static_cast<int64_t>(reported.load(std::memory_order_relaxed)) >
+           static_cast<int64_t>(kWindow)) {
+        if (producer.delivery_mode() == mykafka::DeliveryMode::Inline ||
+            producer.delivery_mode() == mykafka::DeliveryMode::EventLoop)
+            producer.poll(1);
+        else
+            std::this_thread::yield();
+    }
+}
+
+ProducerResult run_producer(const std::string& brokers, const ProducerCase& params, uint64_t messages) {
+    mykafka::Producer producer(mykafka::ClientConfig(brokers), delivery_options(params.mode));
+
+    const std::string payload(params.size, 'x');
+    std::vector<std::string_view> views(params.batch, std::string_view(payload));
+
+    std::atomic<uint64_t> reported{0};
+    std::atomic<uint64_t> errors{0};
+    mykafka::Producer::DeliveryCallback callback = [&](const mykafka::DeliveryReport& report) {
+        if (!report.success)
+            errors.fetch_add(1, std::memory_order_relaxed);
+        reported.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // aquece o pool de contextos e o registro de tópicos
+    for (int i = 0; i < 1000; ++i)
+        producer.send(kProduceTopic, std::string_view(payload), callback);
+    producer.flush(10000);
+    reported.store(0);
+    errors.store(0);
+
+    const uint64_t per_thread = messages / params.threads;
+    std::atomic<uint64_t> sent{0};
+
+    uint64_t allocs_before = g_allocs.load();
+    auto start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < params.threads; ++t) {
+        workers.emplace_back([&]() {
+            uint64_t done = 0;
+            while (done < per_thread) {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(params.batch, per_thread - done));
+                wait_window(producer, sent.fetch_add(n, std::memory_order_relaxed) + n, reported);
+                if (n == 1)
+                    producer.send(kProduceTopic, std::string_view(payload), callback);
+                else
+                    producer.send_batch(kProduceTopic, views.data(), n,
+                                        mykafka::Producer::ANY_PARTITION, callback);
+                done += n;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    const uint64_t total = per_thread * params.threads;
+    while (reported.load() < total)
+        producer.flush(100);
+
+    ProducerResult result;
+    result.seconds = seconds_since(start);
+    result.allocs_per_msg = double(g_allocs.load() - allocs_before) / total;
+    result.params = params;
+    result.messages = total;
+    result.errors = errors.load();
+    result.msgs_per_sec = total / result.seconds;
+    result.mb_per_sec = double(total) * params.size / result.seconds / (1024.0 * 1024.0);
+
+    for (const auto& topic : producer.delivery_latency()) {
+        if (topic.topic == kProduceTopic) {
+            result.p50_us = topic.delivery.p50_us;
+            result.p99_us = topic.delivery.p99_us;
+        }
+    }
+    return result;
+}
+
+ConsumerResult run_consumer(const std::string& brokers, size_t size, uint64_t messages) {
+    {
+        // popula o tópico de consumo
+        mykafka::Producer producer(mykafka::ClientConfig(brokers).linger_ms(5));
+        const std::string payload(size, 'c');
+        for (uint64_t i = 0; i < messages; ++i) {
+            producer.send(kConsumeTopic, std::string_view(payload));
+            if (i % kWindow == kWindow - 1)
+                producer.flush(10000);
+        }
+        producer.flush(10000);
+    }
+
+    mykafka::Consumer consumer(mykafka::ClientConfig(brokers)
+                                   .group_id("kafka-bench-" + std::to_string(messages))
+                                   .auto_offset_reset("earliest"),
+                               {kConsumeTopic});
+
+    ConsumerResult result;
+    result.size = size;
+
+    uint64_t received = 0;
+    uint64_t bytes = 0;
+    uint64_t allocs_before = 0;
+    Clock::time_point start;
+    auto last_progress = Clock::now();
+
+    // o relógio começa na primeira mensagem: o rebalance inicial não conta
+    while (received < messages && seconds_since(last_progress) < 10.0) {
+        size_t n = consumer.poll_batch([&](const mykafka::MessageBatch& batch) {
+            if (received == 0) {
+                start = Clock::now();
+                allocs_before = g_allocs.load();
+            }
+            for (const auto& msg : batch)
+                bytes += msg.payload().size();
+        }, 1000, 100);
+
+        if (n > 0) {
+            received += n;
+            last_progress = Clock::now();
+        }
+    }
+
+    if (received == 0)
+        return result;
+
+    result.seconds = seconds_since(start);
+    result.allocs_per_msg = double(g_allocs.load() - allocs_before) / received;
+    result.messages = received;
+    result.msgs_per_sec = received / result.seconds;
+    result.mb_per_sec = double(bytes) / result.seconds / (1024.0 * 1024.0);
+
+    mykafka::LatencySnapshot latency = consumer.processing_latency();
+    result.p50_us = latency.p50_us;
+    result.p99_us = latency.p99_us;
+    return result;
+}
+
+void print_header() {
+    std::cout << std::left
+              << std::setw(8)  << "size"
+              << std::setw(7)  << "batch"
+              << std::setw(14) << "mode"
+              << std::setw(9)  << "threads"
+              << std::right
+              << std::setw(12) << "msgs/s"
+              << std::setw(10) << "MB/s"
+              << std::setw(10) << "p50 us"
+              << std::setw(10) << "p99 us"
+              << std::setw(11) << "allocs/msg"
+              << std::setw(8)  << "errors" << "\n";
+}
+
+void print(const ProducerResult& r) {
+    std::cout << std::left
+              << std::setw(8)  << r.params.size
+              << std::setw(7)  << r.params.batch
+              << std::setw(14) << mode_name(r.params.mode)
+              << std::setw(9)  << r.params.threads
+              << std::right << std::fixed
+              << std::setw(12) << std::setprecision(0) << r.msgs_per_sec
+              << std::setw(10) << std::setprecision(1) << r.mb_per_sec
+              << std::setw(10) << r.p50_us
+              << std::setw(10) << r.p99_us
+              << std::setw(11) << std::setprecision(2) << r.allocs_per_msg
+              << std::setw(8)  << r.errors << "\n";
+}
+
+std::string to_json(uint64_t messages,
+                    const std::vector<ProducerResult>& producers,
+                    const ConsumerResult& consumer) {
+    std::ostringstream out;
+    out << "{\n  \"messages_per_case\": " << messages << ",\n  \"producer\": [\n";
+    for (size_t i = 0; i < producers.size(); ++i) {
+        const ProducerResult& r = producers[i];
+        out << "    {\"size\": " << r.params.size
+            << ", \"batch\": " << r.params.batch
+            << ", \"mode\": \"" << mode_name(r.params.mode) << "\""
+            << ", \"threads\": " << r.params.threads
+            << ", \"messages\": " << r.messages
+            << ", \"errors\": " << r.errors
+            << ", \"seconds\": " << r.seconds
+            << ", \"msgs_per_sec\": " << r.msgs_per_sec
+            << ", \"mb_per_sec\": " << r.mb_per_sec
+            << ", \"p50_us\": " << r.p50_us
+            << ", \"p99_us\": " << r.p99_us
+            << ", \"allocs_per_msg\": " << r.allocs_per_msg << "}"
+            << (i + 1 < producers.size() ? ",\n" : "\n");
+    }
+    out << "  ],\n  \"consumer\": {\"size\": " << consumer.size
+        << ", \"messages\": " << consumer.messages
+        << ", \"seconds\": " << consumer.seconds
+        << ", \"msgs_per_sec\": " << consumer.msgs_per_sec
+        << ", \"mb_per_sec\": " << consumer.mb_per_sec
+        << ", \"p50_us\": " << consumer.p50_us
+        << ", \"p99_us\": " << consumer.p99_us
+        << ", \"allocs_per_msg\": " << consumer.allocs_per_msg << "}\n}\n";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    std::string json_path = argc > 2 ? argv[2] : "kafka_bench.json";
+
+    try {
+        MockCluster cluster(3);
+        cluster.create_topic(kProduceTopic, kPartitions);
+        cluster.create_topic(kConsumeTopic, kPartitions);
+        const std::string brokers = cluster.bootstraps();
+
+        std::cout << "mock cluster: " << brokers << ", " << messages << " mensagens por caso\n\n";
+        print_header();
+
+        std::vector<ProducerResult> producers;
+        for (size_t size : {64, 1024, 16384}) {
+            for (size_t batch : {1, 100}) {
+                for (auto mode : {mykafka::DeliveryMode::Inline,
+                                  mykafka::DeliveryMode::EventThread,
+                                  mykafka::DeliveryMode::Executor}) {
+                    for (int threads : {1, 4}) {
+                        producers.push_back(run_producer(brokers, {size, batch, mode, threads}, messages));
+                        print(producers.back());
+                    }
+                }
+            }
+        }
+
+        ConsumerResult consumer = run_consumer(brokers, 1024, messages * 5);
+        std::cout << "\nconsumer (poll_batch, " << consumer.size << " bytes): "
+                  << std::fixed << std::setprecision(0) << consumer.msgs_per_sec << " msgs/s, "
+                  << std::setprecision(1) << consumer.mb_per_sec << " MB/s, p50 "
+                  << consumer.p50_us << " us, p99 " << consumer.p99_us << " us, "
+                  << std::setprecision(2) << consumer.allocs_per_msg << " allocs/msg ("
+                  << consumer.messages << " mensagens)\n";
+
+        std::ofstream out(json_path);
+        out << to_json(messages, producers, consumer);
+        std::cout << "\nJSON: " << json_path << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
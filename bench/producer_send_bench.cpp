@@ -0,0 +1,120 @@
+// Microbenchmark do caminho síncrono Producer::send contra o mock cluster
+// da librdkafka (não precisa de broker real).
+//
+// Compara o caminho antigo (rd_kafka_topic_new/destroy a cada mensagem)
+// com o Producer atual, que reaproveita os handles do registro de tópicos.
+//
+// Uso: producer_send_bench [mensagens] [tamanho] [threads]
+#include "producer.hpp"
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* kTopic = "bench-topic";
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Caminho antigo: cria e destrói o handle do tópico para cada mensagem
+double run_legacy(const std::string& brokers, int messages, const std::string& payload, int threads) {
+    char errstr[512];
+    rd_kafka_conf_t* conf = rd_kafka_conf_new();
+    rd_kafka_conf_set(conf, "bootstrap.servers", brokers.c_str(), errstr, sizeof(errstr));
+    rd_kafka_t* rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+    if (!rk)
+        throw std::runtime_error(errstr);
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < messages / threads; ++i) {
+                rd_kafka_topic_t* rkt = rd_kafka_topic_new(rk, kTopic, nullptr);
+                while (rd_kafka_produce(rkt, RD_KAFKA_PARTITION_UA, RD_KAFKA_MSG_F_COPY,
+                                        (void*)payload.data(), payload.size(),
+                                        nullptr, 0, nullptr) != 0) {
+                    rd_kafka_poll(rk, 1); // fila cheia: espera esvaziar
+                }
+                rd_kafka_poll(rk, 0);
+                rd_kafka_topic_destroy(rkt);
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    double elapsed = seconds_since(start);
+
+    rd_kafka_flush(rk, 10000);
+    rd_kafka_destroy(rk);
+    return elapsed;
+}
+
+// Caminho atual: Producer::send com handles cacheados
+double run_registry(const std::string& brokers, int messages, const std::string& payload, int threads) {
+    mykafka::Producer producer(brokers);
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < messages / threads; ++i)
+                producer.send(kTopic, payload);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    double elapsed = seconds_since(start);
+
+    producer.flush(10000);
+    for (const auto& c : producer.topic_counters()) {
+        std::cout << "  [" << c.topic << "] messages=" << c.messages
+                  << " bytes=" << c.bytes << " errors=" << c.errors << "\n";
+    }
+    return elapsed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int messages = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int size     = argc > 2 ? std::atoi(argv[2]) : 256;
+    int threads  = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    // rd_kafka_t auxiliar que hospeda o mock cluster
+    char errstr[512];
+    rd_kafka_t* mock_rk = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr, sizeof(errstr));
+    if (!mock_rk) {
+        std::cerr << "Erro criando handle do mock: " << errstr << std::endl;
+        return 1;
+    }
+    rd_kafka_mock_cluster_t* mcluster = rd_kafka_mock_cluster_new(mock_rk, 3);
+    rd_kafka_mock_topic_create(mcluster, kTopic, 8, 1);
+    const std::string brokers = rd_kafka_mock_cluster_bootstraps(mcluster);
+
+    const std::string payload(size, 'x');
+
+    std::cout << "mensagens=" << messages << " tamanho=" << size
+              << " threads=" << threads << "\n";
+
+    double legacy = run_legacy(brokers, messages, payload, threads);
+    std::cout << "topic_new/destroy por mensagem: " << (messages / legacy) << " msgs/s\n";
+
+    double cached = run_registry(brokers, messages, payload, threads);
+    std::cout << "registro de tópicos:            " << (messages / cached) << " msgs/s\n";
+
+    rd_kafka_mock_cluster_destroy(mcluster);
+    rd_kafka_destroy(mock_rk);
+    return 0;
+}
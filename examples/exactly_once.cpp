@@ -0,0 +1,126 @@
+#include "producer.hpp"
+#include "consumer.hpp"
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Consome de <entrada>, transforma (maiúsculas) e produz em <saida> com
+// exactly-once: mensagens produzidas e offsets consumidos são confirmados na
+// mesma transação. Com --mock roda contra o mock cluster da librdkafka.
+
+// Cluster falso em memória; vive enquanto o handle existir
+class MockCluster {
+public:
+    explicit MockCluster(int brokers) {
+        char errstr[512];
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        std::string count = std::to_string(brokers);
+        if (rd_kafka_conf_set(conf, "test.mock.num.brokers", count.c_str(),
+                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            rd_kafka_conf_destroy(conf);
+            throw std::runtime_error(errstr);
+        }
+        rk_ = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+        if (!rk_)
+            throw std::runtime_error(std::string("Erro criando handle do mock: ") + errstr);
+        cluster_ = rd_kafka_handle_mock_cluster(rk_);
+    }
+
+    ~MockCluster() { rd_kafka_destroy(rk_); }
+
+    void create_topic(const std::string& topic, int partitions) {
+        rd_kafka_mock_topic_create(cluster_, topic.c_str(), partitions, 1);
+    }
+
+    std::string bootstraps() const { return rd_kafka_mock_cluster_bootstraps(cluster_); }
+
+private:
+    rd_kafka_t* rk_ = nullptr;
+    rd_kafka_mock_cluster_t* cluster_ = nullptr;
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Uso: " << argv[0] << " <ip:porta | --mock> <grupo_id> <entrada> <saida>" << std::endl;
+        std::cerr << "Exemplo: " << argv[0] << " --mock copia entrada saida" << std::endl;
+        return 1;
+    }
+
+    std::string brokers = argv[1];
+    const std::string group = argv[2];
+    const std::string input = argv[3];
+    const std::string output = argv[4];
+
+    // no mock, a entrada é preenchida aqui e o programa termina ao copiá-la
+    const int mock_messages = 10000;
+    std::unique_ptr<MockCluster> mock;
+    if (brokers == "--mock") {
+        mock = std::make_unique<MockCluster>(3);
+        mock->create_topic(input, 4);
+        mock->create_topic(output, 4);
+        brokers = mock->bootstraps();
+
+        mykafka::Producer seed(mykafka::ClientConfig(brokers).idempotence(true));
+        for (int i = 0; i < mock_messages; ++i)
+            seed.send(input, "mensagem " + std::to_string(i));
+        seed.flush(10000);
+    }
+
+    // o consumer não commita: os offsets vão na transação
+    mykafka::ClientConfig consumer_config(brokers);
+    consumer_config.group_id(group)
+        .auto_offset_reset("earliest")
+        .isolation_level("read_committed")
+        .set("enable.auto.commit", "false", mykafka::ClientConfig::Scope::Consumer);
+    mykafka::Consumer consumer(consumer_config, {input});
+
+    // transactional.id estável por instância: uma instância nova cerca a antiga
+    mykafka::ClientConfig producer_config(brokers);
+    producer_config.transactional_id(group + "-" + input).max_in_flight(5);
+    mykafka::Producer producer(producer_config);
+    producer.init_transactions();
+
+    std::cout << "Copiando " << input << " → " << output << " (exactly-once)" << std::endl;
+
+    size_t copied = 0;
+    while (!mock || copied < static_cast<size_t>(mock_messages)) {
+        mykafka::MessageBatch batch = consumer.poll_batch(500, 1000);
+        if (batch.empty())
+            continue;
+
+        try {
+            producer.begin_transaction();
+            for (const mykafka::MessageView& msg : batch) {
+                std::string value(msg.payload());
+                std::transform(value.begin(), value.end(), value.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+                mykafka::ProducerRecord record;
+                record.topic = output;
+                record.value = value;
+                if (msg.has_key())
+                    record.key = msg.key();
+                producer.send(record);
+            }
+            producer.send_offsets_to_transaction(consumer);
+            producer.commit_transaction();
+            copied += batch.size();
+        } catch (const mykafka::TransactionError& e) {
+            std::cerr << e.what() << std::endl;
+            if (e.fatal())
+                return 1;
+            // nada da transação fica visível: volta e processa o lote de novo
+            // (também serve para erros retriable: abortar sempre é permitido)
+            producer.abort_transaction();
+            consumer.rewind_to_committed();
+        }
+    }
+
+    std::cout << "Copiadas " << copied << " mensagens" << std::endl;
+    return 0;
+}
@@ -6,10 +6,6 @@
 #include <iomanip>
 #include <string>
 
-#ifndef ASYNC_MODE
-    #error "ASYNC_MODE NÃO DEFINIDO NO SIMPLE_PRODUCER!"
-#endif
-
 enum class SecurityMode {
     PLAINTEXT,
     TLS,
@@ -40,8 +36,10 @@ int main(int argc, char* argv[]) {
         else if (a == "--ssl-key")  ssl_key  = argv[++i];
     }    
 
-    // 3. Inicializa o Producer
-    mykafka::Producer producer(brokers, ssl_ca, ssl_cert, ssl_key);
+    // 3. Inicializa o Producer (callbacks de entrega numa thread dedicada)
+    mykafka::DeliveryOptions delivery;
+    delivery.mode = mykafka::DeliveryMode::EventThread;
+    mykafka::Producer producer(brokers, delivery, ssl_ca, ssl_cert, ssl_key);
 
     // --- Geração do Timestamp ---
     auto now = std::chrono::system_clock::now();
@@ -91,7 +89,6 @@ int main(int argc, char* argv[]) {
 
     std::cout << "Enviando para o topico '" << topic << "': " << final_message << std::endl;
 
-#ifdef ASYNC_MODE
     producer.send(topic, final_message,[](const mykafka::DeliveryReport& r) 
     {
         std::cout << "============================================" << std::endl;
@@ -113,9 +110,5 @@ int main(int argc, char* argv[]) {
     // garante que os callbacks sejam executados enquanto o ambiente 
     // da aplicação ainda está 100% íntegro e estável.
     producer.flush(5000);   
-#else
-    // 5. Envia a Mensagem com Timestamp
-    producer.send(topic, final_message);
-#endif
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "producer.hpp"
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Derruba os brokers do mock cluster, envia mais do que cabe na marca do
+// transbordo e religa: as mensagens vão para o disco e voltam, em ordem.
+// Uso: spill_outage [diretório] [mensagens]
+
+class MockCluster {
+public:
+    explicit MockCluster(int brokers) : brokers_(brokers) {
+        char errstr[512];
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        std::string count = std::to_string(brokers);
+        if (rd_kafka_conf_set(conf, "test.mock.num.brokers", count.c_str(),
+                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            rd_kafka_conf_destroy(conf);
+            throw std::runtime_error(errstr);
+        }
+        rk_ = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+        if (!rk_)
+            throw std::runtime_error(std::string("Erro criando handle do mock: ") + errstr);
+        cluster_ = rd_kafka_handle_mock_cluster(rk_);
+    }
+
+    ~MockCluster() { rd_kafka_destroy(rk_); }
+
+    void create_topic(const char* topic, int partitions) {
+        rd_kafka_mock_topic_create(cluster_, topic, partitions, 1);
+    }
+
+    // ids dos brokers do mock começam em 1
+    void set_up(bool up) {
+        for (int id = 1; id <= brokers_; ++id) {
+            if (up)
+                rd_kafka_mock_broker_set_up(cluster_, id);
+            else
+                rd_kafka_mock_broker_set_down(cluster_, id);
+        }
+    }
+
+    std::string bootstraps() const { return rd_kafka_mock_cluster_bootstraps(cluster_); }
+
+private:
+    int brokers_;
+    rd_kafka_t* rk_ = nullptr;
+    rd_kafka_mock_cluster_t* cluster_ = nullptr;
+};
+
+void print(const char* phase, const mykafka::SpillStats& s, uint64_t delivered) {
+    std::cout << phase << ": em disco " << s.pending << " (segmentos " << s.segments
+              << "), transbordadas " << s.spilled << ", reenviadas " << s.replayed
+              << ", entregues " << delivered << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const std::string directory = argc > 1 ? argv[1] : "/tmp/mykafka-spill";
+    const int messages = argc > 2 ? std::stoi(argv[2]) : 200000;
+
+    MockCluster mock(3);
+    mock.create_topic("spill-demo", 4);
+
+    mykafka::DeliveryOptions delivery;
+    delivery.mode = mykafka::DeliveryMode::EventThread;
+    delivery.spill.directory = directory;
+    delivery.spill.watermark_messages = 10000;
+    delivery.spill.segment_bytes = 4 << 20;
+
+    mykafka::ClientConfig config(mock.bootstraps());
+    config.idempotence(true).set("message.timeout.ms", "600000");
+    mykafka::Producer producer(config, delivery);
+    if (producer.spill_stats().recovered > 0)
+        std::cout << "Recuperadas do disco: " << producer.spill_stats().recovered << std::endl;
+
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> failed{0};
+    auto on_delivery = [&](const mykafka::DeliveryReport& r) { (r.success ? delivered : failed)++; };
+
+    mock.set_up(false);
+    for (int i = 0; i < messages; ++i)
+        producer.send("spill-demo", "mensagem " + std::to_string(i), on_delivery);
+    print("Brokers fora", producer.spill_stats(), delivered);
+
+    mock.set_up(true);
+    auto start = std::chrono::steady_clock::now();
+    producer.flush(120000);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    print("Brokers de volta", producer.spill_stats(), delivered);
+    std::cout << "Recuperação em " << ms << " ms, falhas " << failed << std::endl;
+
+    return delivered == static_cast<uint64_t>(messages) ? 0 : 1;
+}
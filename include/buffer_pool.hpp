@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include "producer.hpp"
+
+namespace mykafka {
+
+namespace detail {
+
+struct PoolState;
+
+struct PoolBlock {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    size_t capacity = 0;
+    std::shared_ptr<PoolState> owner; // só enquanto o bloco está fora do pool
+};
+
+// Deleter dos Buffer criados por PooledBuffer::release(): devolve o bloco
+void return_block(void* data, void* ctx);
+
+} // namespace detail
+
+// Bloco de bytes tirado de um BufferPool, onde os serializadores escrevem.
+// release() o entrega ao Producer sem cópia; depois do relatório de entrega o
+// bloco volta ao pool com a capacidade que tinha.
+class PooledBuffer {
+public:
+    PooledBuffer(PooledBuffer&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            if (block_)
+                detail::return_block(nullptr, block_);
+            block_ = other.block_;
+            other.block_ = nullptr;
+        }
+        return *this;
+    }
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+    ~PooledBuffer() {
+        if (block_)
+            detail::return_block(nullptr, block_);
+    }
+
+    char* data() { return block_->data.get(); }
+    const char* data() const { return block_->data.get(); }
+    size_t size() const { return block_->size; }
+    size_t capacity() const { return block_->capacity; }
+    std::string_view view() const { return std::string_view(data(), size()); }
+
+    void reserve(size_t capacity) {
+        if (capacity > block_->capacity)
+            grow(capacity);
+    }
+
+    // Aumenta o tamanho em 'n' e devolve onde escrever esses bytes
+    char* extend(size_t n) {
+        size_t size = block_->size;
+        if (size + n > block_->capacity)
+            grow(size + n);
+        block_->size = size + n;
+        return block_->data.get() + size;
+    }
+
+    // Descarta o fim (ex.: depois de um extend maior que o necessário)
+    void truncate(size_t size) {
+        if (size < block_->size)
+            block_->size = size;
+    }
+
+    void append(const void* bytes, size_t n) {
+        if (n > 0)
+            std::memcpy(extend(n), bytes, n);
+    }
+    void append(std::string_view bytes) { append(bytes.data(), bytes.size()); }
+
+    void clear() { block_->size = 0; }
+
+    // Entrega o conteúdo para o Producer; este objeto fica vazio
+    Buffer release() {
+        detail::PoolBlock* block = block_;
+        block_ = nullptr;
+        return Buffer(block->data.get(), block->size, &detail::return_block, block);
+    }
+
+private:
+    friend class BufferPool;
+    explicit PooledBuffer(detail::PoolBlock* block) : block_(block) {}
+
+    void grow(size_t needed);
+
+    detail::PoolBlock* block_;
+};
+
+// Pool de blocos reaproveitáveis, seguro entre threads: o send pega um bloco
+// numa thread e a entrega o devolve em outra. Cópias do BufferPool compartilham
+// os mesmos blocos, e os que ainda estão com a librdkafka mantêm o pool vivo.
+class BufferPool {
+public:
+    // 'max_cached': blocos livres guardados; 'max_block_bytes': blocos maiores
+    // que isso são liberados na devolução em vez de guardados
+    explicit BufferPool(size_t max_cached = 1024, size_t max_block_bytes = 1 << 20);
+
+    PooledBuffer acquire(size_t capacity_hint = 0);
+
+    // blocos livres no pool agora
+    size_t cached() const;
+
+private:
+    std::shared_ptr<detail::PoolState> state_;
+};
+
+} // namespace mykafka
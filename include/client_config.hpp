@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct rd_kafka_conf_s;
+
+namespace mykafka {
+
+// Configuração compartilhada por Producer e Consumer.
+// Os setters tipados cobrem os ajustes de desempenho mais comuns; set() aceita
+// qualquer propriedade da librdkafka. Erros do rd_kafka_conf_set são reportados
+// (std::runtime_error com a propriedade e o motivo) ao criar o cliente.
+class ClientConfig {
+public:
+    // Conjuntos coerentes de ajustes; podem ser sobrescritos depois, um a um
+    enum class Profile {
+        Default,           // padrões da librdkafka
+        LowLatency,        // sem espera para formar lotes, fetch responde cedo
+        HighThroughput,    // lotes grandes, compressão, filas internas maiores
+        MemoryConstrained, // filas internas e fetch pequenos
+    };
+
+    enum class Compression { None, Gzip, Snappy, Lz4, Zstd };
+
+    // Como o producer escolhe a partição quando ela não é informada
+    enum class Partitioner {
+        Murmur2,          // murmur2 da chave, igual ao cliente Java; sem chave, aleatória
+        ConsistentRandom, // CRC32 da chave (padrão da librdkafka); sem chave, aleatória
+        Sticky,           // murmur2 da chave; sem chave, fica numa partição por um tempo (lotes maiores)
+    };
+
+    // Como o grupo divide as partições entre os consumers
+    enum class Assignor {
+        Range,             // padrão; rebalanceamento eager: todos param e devolvem tudo
+        RoundRobin,        // eager
+        CooperativeSticky, // incremental: só as partições que mudam de dono são revogadas
+    };
+
+    // A quem a propriedade se aplica; as de outro papel não são repassadas
+    enum class Scope { Common, Producer, Consumer };
+
+    struct Entry {
+        std::string key;
+        std::string value;
+        Scope scope;
+    };
+
+    ClientConfig() = default;
+    explicit ClientConfig(const std::string& brokers);
+
+    ClientConfig& profile(Profile p);
+
+    // --- comuns ---
+    ClientConfig& brokers(const std::string& brokers);
+    ClientConfig& client_id(const std::string& id);
+    // TLS/mTLS: vazio = não configura. Com CA, desabilita a validação de hostname
+    // (certificados dos brokers usam apenas o IP).
+    ClientConfig& ssl(const std::string& ca, const std::string& cert = "", const std::string& key = "");
+    // intervalo do JSON de estatísticas lido por stats(); 0 (padrão) desliga
+    ClientConfig& statistics_interval_ms(int ms);
+
+    // --- producer ---
+    ClientConfig& linger_ms(int ms);
+    ClientConfig& batch_size(int bytes);
+    ClientConfig& batch_num_messages(int count);
+    ClientConfig& compression(Compression type);
+    ClientConfig& queue_buffering_max_kbytes(int kbytes);
+    ClientConfig& queue_buffering_max_messages(int count);
+    ClientConfig& acks(int acks); // -1 = all
+    // Sem duplicatas nem reordenação em retentativas, com até 5 requisições em
+    // voo por conexão (força acks=all). Implícito com transactional_id.
+    ClientConfig& idempotence(bool enabled);
+    ClientConfig& max_in_flight(int requests); // por conexão; até 5 com idempotência
+    // Habilita as transações do Producer; único por instância lógica do produtor
+    ClientConfig& transactional_id(const std::string& id);
+    // 'sticky_linger_ms': quanto tempo mensagens sem chave ficam na mesma partição (Sticky)
+    ClientConfig& partitioner(Partitioner type, int sticky_linger_ms = 10);
+
+    // --- consumer ---
+    ClientConfig& group_id(const std::string& id);
+    ClientConfig& auto_offset_reset(const std::string& reset); // earliest | latest
+    ClientConfig& assignor(Assignor type);
+    // read_committed (padrão): só entrega mensagens de transações confirmadas | read_uncommitted
+    ClientConfig& isolation_level(const std::string& level);
+    // Membro estático: um restart que volta antes do session.timeout.ms
+    // recupera as mesmas partições sem rebalancear o grupo. Único por instância.
+    ClientConfig& group_instance_id(const std::string& id);
+    ClientConfig& fetch_min_bytes(int bytes);
+    ClientConfig& fetch_wait_max_ms(int ms);
+    ClientConfig& fetch_max_bytes(int bytes);
+    ClientConfig& queued_max_messages_kbytes(int kbytes);
+
+    // qualquer outra propriedade da librdkafka
+    ClientConfig& set(const std::string& key, const std::string& value, Scope scope = Scope::Common);
+
+    // valor atual de uma propriedade ("" se não definida)
+    std::string get(const std::string& key) const;
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    // Aplica as propriedades comuns e as do papel informado em 'conf'.
+    // Lança std::runtime_error no primeiro valor recusado pela librdkafka.
+    void apply(rd_kafka_conf_s* conf, Scope role) const;
+
+private:
+    std::vector<Entry> entries_;
+};
+
+} // namespace mykafka
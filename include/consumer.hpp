@@ -1,17 +1,87 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <cstdint>
+#include "message_view.hpp"
+#include "message_filter.hpp"
+#include "client_config.hpp"
+#include "stats.hpp"
+#include "latency_histogram.hpp"
+
+struct rd_kafka_s;
 
 namespace mykafka {
 
+// Lote devolvido pelo poll_batch. É dono das mensagens da librdkafka:
+// as views de cada item valem enquanto o lote existir (ou até retain()).
+class MessageBatch {
+public:
+    using Item = MessageView;
+
+    MessageBatch() = default;
+    MessageBatch(MessageBatch&& other) noexcept = default;
+    MessageBatch& operator=(MessageBatch&& other) noexcept;
+    MessageBatch(const MessageBatch&) = delete;
+    MessageBatch& operator=(const MessageBatch&) = delete;
+    ~MessageBatch();
+
+    // itens contíguos em memória: podem ser percorridos como um span
+    const Item* data() const { return items_.data(); }
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    const Item& operator[](size_t i) const { return items_[i]; }
+    const Item* begin() const { return items_.data(); }
+    const Item* end() const { return items_.data() + items_.size(); }
+
+private:
+    friend class Consumer;
+    void clear();
+
+    std::vector<Item> items_;
+    std::vector<rd_kafka_message_s*> raw_; // todas as mensagens recebidas, inclusive erros (nulo = retida)
+};
+
+// Commit manual com Consumer::ack(). Desliga o enable.auto.commit: só é
+// commitado o que foi confirmado, até o último offset contíguo de cada partição.
+struct AckOptions {
+    bool enabled = false;
+    int commit_interval_ms = 1000; // commit assíncrono no máximo a cada intervalo...
+    size_t commit_every = 10000;   // ...ou a cada N acks, o que vier primeiro
+};
+
+// Contadores do filtro (Consumer::set_filter)
+struct FilterCounters {
+    uint64_t passed = 0;  // entregues ao callback
+    uint64_t dropped = 0; // descartadas antes do callback
+};
+
+struct TopicPartition {
+    std::string topic;
+    int32_t partition = 0;
+};
+
+// Chamados dentro do poll/poll_batch/drain, na thread que consome, quando o
+// grupo muda. Com ClientConfig::Assignor::CooperativeSticky as listas trazem
+// só as partições que mudaram de dono; as demais continuam sendo consumidas.
+struct RebalanceHooks {
+    using Callback = std::function<void(const std::vector<TopicPartition>& partitions)>;
+    Callback on_assigned; // depois do assign: dá para pausar ou carregar estado aqui
+    Callback on_revoked;  // antes do commit (com ack) e de entregar as partições
+    Callback on_lost;     // saímos do grupo sem revogação ordenada: não há como commitar
+};
+
 class Consumer {
 public:
     //using MessageCallback = std::function<void(const std::string& message)>;
     //Adicionar 'const std::string& topic' ao callback
     using MessageCallback = std::function<void(const std::string& topic, const std::string& message)>;    
+    using BatchCallback = std::function<void(const MessageBatch& batch)>;
+    // Recebe a mensagem sem cópias, com chave, cabeçalhos, partição, offset e timestamp
+    using ViewCallback = std::function<void(const MessageView& message)>;
 
     Consumer(const std::string& brokers,
             const std::string& groupId,
@@ -19,11 +89,83 @@ public:
             const std::string& ssl_ca   = "",
             const std::string& ssl_cert = "",
             const std::string& ssl_key  = "");
+    // configuração completa (group.id obrigatório): fetch.min.bytes, perfis, etc.
+    Consumer(const ClientConfig& config, const std::vector<std::string>& topics,
+             const AckOptions& acks = AckOptions());
     ~Consumer();
 
     void poll(MessageCallback callback, int timeout_ms = 1000);
+    void poll(ViewCallback callback, int timeout_ms = 1000);
+
+    // Busca até 'max_messages' de uma vez na fila do consumer.
+    // Retorna assim que houver 'max_messages' ou quando 'timeout_ms' expirar.
+    MessageBatch poll_batch(size_t max_messages = 1000, int timeout_ms = 1000);
+
+    // Mesmo que o anterior, mas entrega o lote ao callback e reaproveita a
+    // memória entre chamadas. Retorna quantas mensagens foram entregues.
+    size_t poll_batch(BatchCallback callback, size_t max_messages = 1000, int timeout_ms = 1000);
+
+    // --- integração com event loop (epoll) ---
+    // eventfd que fica legível quando a fila do consumer recebe mensagens ou
+    // eventos (rebalance, erros, estatísticas). Criado na primeira chamada.
+    int fd();
+    // Entrega ao callback, sem bloquear, tudo que estiver pronto (até
+    // 'max_messages') e rearma o fd. Retorna quantas mensagens foram entregues;
+    // menos que 'max_messages' significa que a fila ficou vazia.
+    size_t drain(ViewCallback callback, size_t max_messages = SIZE_MAX);
+
+    // Alternativa ao fd(), sem eventfd: chamado numa thread interna da
+    // librdkafka quando a fila passa de vazia para não vazia. Não consuma
+    // dentro dele, só acorde quem vai chamar drain(). Exclusivo com fd().
+    void set_ready_callback(std::function<void()> callback);
+
+    // Descarta, antes de montar a view e chamar o callback, as mensagens que não
+    // passam no filtro (vale para poll, poll_batch e drain). O offset delas conta
+    // como processado: com ack() elas já saem confirmadas. Filtro vazio desliga.
+    // Chame antes do primeiro poll.
+    void set_filter(MessageFilter filter);
+    FilterCounters filter_counters() const;
+
+    // Substitui os hooks de rebalanceamento. Chame antes do primeiro poll.
+    void set_rebalance_hooks(RebalanceHooks hooks);
+
+    // Controle de fluxo por partição, sem sair do grupo: pausadas deixam de ser
+    // buscadas e entregues; resume() continua da posição atual. Partições
+    // revogadas e atribuídas de novo voltam despausadas. Falha (ex.: partição
+    // não atribuída) vira std::runtime_error, depois de aplicar às demais.
+    void pause(const std::vector<TopicPartition>& partitions);
+    void resume(const std::vector<TopicPartition>& partitions);
+    // partições atribuídas a este consumer agora
+    std::vector<TopicPartition> assignment() const;
+
+    // Volta as partições atribuídas ao último offset commitado (sem commit:
+    // ao auto.offset.reset), descartando o que já foi buscado. Usado depois de
+    // Producer::abort_transaction para reprocessar a transação perdida.
+    void rewind_to_committed(int timeout_ms = 10000);
+
+    // Confirma que a mensagem foi processada (requer AckOptions::enabled).
+    // Pode ser chamado de qualquer thread e fora de ordem: o commit só avança
+    // sobre offsets contíguos. Os commits saem agrupados e assíncronos; o
+    // último é síncrono, na destruição do Consumer.
+    void ack(const MessageView& message);
+
+    // Commit síncrono imediato de tudo que já foi confirmado
+    void commit();
+
+    // Latências medidas ao redor dos callbacks de poll() e poll_batch(callback):
+    // só o tempo do callback (sem a espera na fila de pré-busca da librdkafka)...
+    LatencySnapshot processing_latency() const;
+    // ...e do timestamp da mensagem (produção) até o callback retornar
+    LatencySnapshot end_to_end_latency() const;
+
+    // Últimas estatísticas da librdkafka (requer statistics.interval.ms > 0):
+    // lag e fila de pré-busca por partição, RTT e throttle por broker.
+    ClientStats stats() const;
 
 private:
+    friend class Producer; // send_offsets_to_transaction
+    rd_kafka_s* handle() const;
+
     class Impl;
     std::unique_ptr<Impl> impl_;
 };
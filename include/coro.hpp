@@ -0,0 +1,222 @@
+#pragma once
+
+// Camada opcional de corrotinas (C++20) sobre Producer e Consumer.
+// Habilite com -DENABLE_COROUTINES=ON.
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "coro.hpp requer C++20 com corrotinas (-DENABLE_COROUTINES=ON)"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "producer.hpp"
+#include "consumer.hpp"
+
+namespace mykafka::coro {
+
+// Onde as corrotinas retomam. post() precisa ser thread-safe: é chamado
+// das threads da librdkafka (relatórios de entrega, fila com dados).
+class Scheduler {
+public:
+    virtual ~Scheduler() = default;
+    virtual void post(std::coroutine_handle<> handle) = 0;
+
+    // co_await scheduler.schedule(): continua a corrotina dentro do scheduler
+    auto schedule() {
+        struct Awaiter {
+            Scheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { scheduler.post(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+};
+
+// Executor mínimo: roda as corrotinas agendadas numa única thread, a que chama run()
+class SingleThreadExecutor : public Scheduler {
+public:
+    void post(std::coroutine_handle<> handle) override;
+
+    // roda até stop()
+    void run();
+    // roda o que já estiver agendado, sem bloquear; retorna quantas retomadas
+    size_t run_pending();
+    void stop();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::coroutine_handle<>> ready_;
+    std::vector<std::coroutine_handle<>> running_; // reaproveitado entre rodadas
+    bool stopped_ = false;
+};
+
+namespace detail {
+
+template <typename T>
+struct TaskResult {
+    std::optional<T> value;
+    void return_value(T v) { value.emplace(std::move(v)); }
+    T take() { return std::move(*value); }
+};
+
+template <>
+struct TaskResult<void> {
+    void return_void() noexcept {}
+    void take() noexcept {}
+};
+
+} // namespace detail
+
+// Corrotina preguiçosa: só começa quando alguém faz co_await nela
+template <typename T = void>
+class Task {
+public:
+    struct promise_type : detail::TaskResult<T> {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // devolve o controle a quem esperava, sem empilhar (transferência simétrica)
+        auto final_suspend() noexcept {
+            struct Final {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return Final{};
+        }
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() {
+                if (handle.promise().error)
+                    std::rethrow_exception(handle.promise().error);
+                return handle.promise().take();
+            }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Roda a tarefa no scheduler sem esperar por ela (exceções vão para o stderr)
+void spawn(Scheduler& scheduler, Task<void> task);
+
+// Envio que retoma com o DeliveryReport, no scheduler, quando o relatório chega.
+// O payload não é copiado: ele vive até a corrotina retomar.
+class SendAwaiter {
+public:
+    SendAwaiter(Producer& producer, Scheduler& scheduler, const std::string& topic,
+                std::string_view value, const ProducerRecord* record)
+        : producer_(producer), scheduler_(scheduler), topic_(topic), value_(value), record_(record) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h);
+    DeliveryReport await_resume() { return std::move(report_); }
+
+private:
+    Producer& producer_;
+    Scheduler& scheduler_;
+    const std::string& topic_;
+    std::string_view value_;
+    const ProducerRecord* record_;
+    DeliveryReport report_;
+};
+
+// co_await producer.send(...) sobre um Producer existente. Funciona melhor com
+// DeliveryMode::EventThread; nos modos Inline/EventLoop alguém precisa chamar
+// poll()/drain() para os relatórios chegarem.
+class AsyncProducer {
+public:
+    AsyncProducer(Producer& producer, Scheduler& scheduler)
+        : producer_(producer), scheduler_(scheduler) {}
+
+    SendAwaiter send(const std::string& topic, std::string_view value) {
+        return SendAwaiter(producer_, scheduler_, topic, value, nullptr);
+    }
+    SendAwaiter send(const ProducerRecord& record) {
+        return SendAwaiter(producer_, scheduler_, record.topic, record.value, &record);
+    }
+
+private:
+    Producer& producer_;
+    Scheduler& scheduler_;
+};
+
+// co_await consumer.next() / next_batch(): suspende enquanto a fila estiver
+// vazia e retoma no scheduler quando chegam dados, sem thread bloqueada.
+// Usa o set_ready_callback do Consumer (exclusivo com fd()). Uma corrotina
+// esperando por vez.
+class AsyncConsumer {
+public:
+    AsyncConsumer(Consumer& consumer, Scheduler& scheduler);
+    ~AsyncConsumer();
+
+    AsyncConsumer(const AsyncConsumer&) = delete;
+    AsyncConsumer& operator=(const AsyncConsumer&) = delete;
+
+    Task<Message> next();
+    Task<std::vector<Message>> next_batch(size_t max_messages = 1000);
+
+private:
+    // suspende até a fila receber algo (ou retorna na hora, se já recebeu)
+    struct ReadyAwaiter {
+        AsyncConsumer& self;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h);
+        void await_resume() const noexcept {}
+    };
+
+    void on_ready(); // thread da librdkafka
+
+    Consumer& consumer_;
+    Scheduler& scheduler_;
+    std::atomic<bool> ready_{false};
+    std::atomic<void*> waiter_{nullptr};
+};
+
+} // namespace mykafka::coro
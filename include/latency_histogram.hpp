@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace mykafka {
+
+// Percentis de um histograma, em microssegundos
+struct LatencySnapshot {
+    uint64_t count = 0;
+    double mean_us = 0;
+    uint64_t p50_us = 0;
+    uint64_t p90_us = 0;
+    uint64_t p99_us = 0;
+    uint64_t p999_us = 0;
+    uint64_t max_us = 0;
+};
+
+// Histograma de latência log-linear (estilo HDR), sem locks.
+// Cada potência de 2 é dividida em 16 faixas: erro relativo máximo de ~6%,
+// de 1 µs até 2^47 µs, em ~6 KB. record() é um único fetch_add relaxed;
+// snapshot() pode rodar em paralelo com as gravações.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kMaxExponent = 47;
+    static constexpr size_t kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+    void record(uint64_t us, uint64_t count = 1) {
+        buckets_[index_of(us)].fetch_add(count, std::memory_order_relaxed);
+        sum_us_.fetch_add(us * count, std::memory_order_relaxed);
+    }
+
+    LatencySnapshot snapshot() const;
+    void reset();
+
+    static size_t index_of(uint64_t v) {
+        if (v < static_cast<uint64_t>(kSubBuckets))
+            return static_cast<size_t>(v);
+        int e = 63 - __builtin_clzll(v);
+        if (e > kMaxExponent)
+            return kBuckets - 1;
+        size_t sub = static_cast<size_t>((v >> (e - kSubBits)) & (kSubBuckets - 1));
+        return static_cast<size_t>(e - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    // maior valor que cai no bucket (o percentil reportado nunca subestima)
+    static uint64_t upper_bound_of(size_t idx) {
+        if (idx < static_cast<size_t>(kSubBuckets))
+            return idx;
+        int e = static_cast<int>(idx / kSubBuckets) + kSubBits - 1;
+        uint64_t sub = idx % kSubBuckets;
+        uint64_t width = uint64_t(1) << (e - kSubBits);
+        return ((kSubBuckets + sub) << (e - kSubBits)) + width - 1;
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+    std::atomic<uint64_t> sum_us_{0};
+};
+
+} // namespace mykafka
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct rd_kafka_message_s;
+
+namespace mykafka {
+
+// Filtro aplicado pelo Consumer na mensagem crua da librdkafka, antes de
+// montar a MessageView e chamar o callback. Cada chamada acrescenta um
+// predicado e a mensagem passa só se todos valerem. A ordem de avaliação é
+// fixa, do mais barato ao mais caro: chave, cabeçalhos, payload.
+//
+//   consumer.set_filter(MessageFilter()
+//       .header_equals("tipo", "pedido")
+//       .payload_contains_any({"\"status\":\"pago\"", "\"status\":\"estornado\""}));
+class MessageFilter {
+public:
+    // último cabeçalho 'name' com exatamente 'value' (ausente ou nulo não passa)
+    MessageFilter& header_equals(std::string name, std::string value);
+    // chave começando por 'prefix' (sem chave não passa)
+    MessageFilter& key_prefix(std::string prefix);
+    // payload contendo 'pattern'
+    MessageFilter& payload_contains(std::string pattern);
+    // payload contendo ao menos um dos padrões
+    MessageFilter& payload_contains_any(std::vector<std::string> patterns);
+
+    bool empty() const;
+    bool matches(const rd_kafka_message_s* msg) const;
+
+    // Conjunto de instruções escolhido para a busca no payload nesta CPU:
+    // "avx2", "sse2" ou "scalar"
+    static const char* simd_level();
+
+private:
+    struct HeaderEquals {
+        std::string name;
+        std::string value;
+    };
+
+    std::vector<std::string> key_prefixes_;
+    std::vector<HeaderEquals> headers_;
+    std::vector<std::vector<std::string>> payload_; // cada item: ao menos um dos padrões
+};
+
+} // namespace mykafka
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+struct rd_kafka_message_s;
+struct rd_kafka_headers_s;
+
+namespace mykafka {
+
+class Message;
+
+// Cabeçalho de uma mensagem. As views apontam para a memória da librdkafka.
+// Um valor nulo chega como view vazia com data() == nullptr.
+struct Header {
+    std::string_view name;
+    std::string_view value;
+};
+
+// Visão de uma mensagem recebida, sem cópias. Todas as views valem enquanto a
+// mensagem da librdkafka estiver viva: durante o callback, enquanto o
+// MessageBatch existir, ou enquanto o Message obtido com retain() existir.
+class MessageView {
+public:
+    // Cabeçalhos decodificados sob demanda: nada é lido até que sejam iterados
+    class Headers {
+    public:
+        class iterator {
+        public:
+            iterator(const rd_kafka_headers_s* hdrs, size_t idx) : hdrs_(hdrs), idx_(idx) {}
+            Header operator*() const;
+            iterator& operator++() { ++idx_; return *this; }
+            bool operator==(const iterator& o) const { return idx_ == o.idx_; }
+            bool operator!=(const iterator& o) const { return idx_ != o.idx_; }
+        private:
+            const rd_kafka_headers_s* hdrs_;
+            size_t idx_;
+        };
+
+        explicit Headers(const rd_kafka_headers_s* hdrs) : hdrs_(hdrs) {}
+
+        size_t size() const;
+        bool empty() const { return size() == 0; }
+        iterator begin() const { return iterator(hdrs_, 0); }
+        iterator end() const { return iterator(hdrs_, size()); }
+
+        // último valor com esse nome; false se não existir
+        bool find(std::string_view name, std::string_view& value) const;
+
+    private:
+        const rd_kafka_headers_s* hdrs_;
+    };
+
+    MessageView() = default;
+    explicit MessageView(const rd_kafka_message_s* msg, rd_kafka_message_s** owner = nullptr)
+        : msg_(msg), owner_(owner) {}
+
+    std::string_view topic() const;
+    std::string_view key() const;
+    std::string_view payload() const;
+    bool has_key() const;
+
+    int32_t partition() const;
+    int64_t offset() const;
+    // timestamp em ms desde a epoch (CreateTime ou LogAppendTime); -1 se indisponível
+    int64_t timestamp() const;
+
+    Headers headers() const;
+
+    // Assume a mensagem sem copiá-la, para usá-la depois do callback.
+    // Só funciona uma vez e apenas para views entregues pelo Consumer;
+    // caso contrário devolve um Message vazio.
+    Message retain() const;
+
+    const rd_kafka_message_s* raw() const { return msg_; }
+
+private:
+    const rd_kafka_message_s* msg_ = nullptr;
+    rd_kafka_message_s** owner_ = nullptr; // quem libera a mensagem, se ainda não foi retida
+};
+
+// Mensagem retida com MessageView::retain(): dona do rd_kafka_message_t,
+// que é devolvido à librdkafka no destrutor.
+class Message {
+public:
+    Message() = default;
+    explicit Message(rd_kafka_message_s* msg) : msg_(msg) {}
+    Message(Message&& other) noexcept : msg_(other.msg_) { other.msg_ = nullptr; }
+    Message& operator=(Message&& other) noexcept;
+    Message(const Message&) = delete;
+    Message& operator=(const Message&) = delete;
+    ~Message();
+
+    explicit operator bool() const { return msg_ != nullptr; }
+    MessageView view() const { return MessageView(msg_); }
+
+private:
+    rd_kafka_message_s* msg_ = nullptr;
+};
+
+} // namespace mykafka
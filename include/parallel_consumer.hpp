@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include "message_view.hpp"
+#include "client_config.hpp"
+
+namespace mykafka {
+
+struct WorkerOptions {
+    // Como as mensagens são distribuídas entre os workers
+    enum class Dispatch {
+        Partition, // cada partição fica sempre no mesmo worker: ordem por partição
+        Key,       // mesma chave → mesmo worker: ordem por chave (sem chave, cai na partição)
+    };
+
+    size_t workers = 0;           // 0 = std::thread::hardware_concurrency()
+    size_t queue_capacity = 4096; // mensagens por worker; cheia, o poll espera
+    Dispatch dispatch = Dispatch::Partition;
+    int commit_interval_ms = 1000; // commits assíncronos dos offsets já processados
+    size_t max_batch = 1000;       // mensagens buscadas por poll
+};
+
+// Consumer que busca numa thread (a que chama poll) e processa em N workers,
+// cada um com sua fila SPSC limitada. Um único membro no grupo usa todos os núcleos.
+//
+// O offset de uma partição só é commitado depois que todas as mensagens
+// anteriores a ele foram processadas (at-least-once). enable.auto.commit é
+// desligado; o último commit é síncrono, na destruição.
+class ParallelConsumer {
+public:
+    // Chamado nos workers. A view vale durante a chamada (ou use retain()).
+    // Exceções são registradas no stderr e a mensagem conta como processada.
+    using Handler = std::function<void(const MessageView& message)>;
+
+    ParallelConsumer(const ClientConfig& config,
+                     const std::vector<std::string>& topics,
+                     Handler handler,
+                     const WorkerOptions& options = WorkerOptions());
+    // espera os workers esvaziarem as filas, commita e sai do grupo
+    ~ParallelConsumer();
+
+    // Busca mensagens e as distribui aos workers; também dispara os commits
+    // periódicos e os rebalanceamentos. Deve ser chamado sempre da mesma thread.
+    // Retorna quantas mensagens foram despachadas.
+    size_t poll(int timeout_ms = 1000);
+
+    // Espera tudo que foi despachado terminar e commita de forma síncrona
+    void commit();
+
+    size_t workers() const;
+    uint64_t processed() const; // mensagens já processadas pelos workers
+    size_t in_flight() const;   // despachadas e ainda não processadas
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace mykafka
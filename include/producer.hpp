@@ -1,44 +1,271 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <functional>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <stdexcept>
+#include "client_config.hpp"
+#include "message_view.hpp"
+#include "stats.hpp"
+#include "latency_histogram.hpp"
 
 namespace mykafka {
 
-#ifdef ASYNC_MODE
+    class Consumer;
+
     struct DeliveryReport {
        bool success;
        std::string error;
        int32_t partition; // Partição 0 → offsets 0,1,2,3...
        int64_t offset; // é o número da posição da mensagem dentro de uma partição do tópico.
     };
-#endif
-    
+
+    // Onde os relatórios de entrega (e portanto os DeliveryCallback) são executados.
+    // Escolhido na construção do Producer; dá para ter Producers em modos diferentes
+    // no mesmo binário.
+    enum class DeliveryMode {
+        Inline,      // na thread que chama send/poll/flush (menor latência, sem threads extras)
+        EventThread, // numa thread dedicada, bloqueada na fila da librdkafka
+        Executor,    // a thread dedicada entrega lotes de relatórios a um executor do chamador
+        EventLoop,   // sem threads: o loop do chamador (epoll) espera fd() e chama drain()
+    };
+
+    // Transbordo em disco para quedas dos brokers. Quando a fila da librdkafka
+    // passa da marca (ou enche), os envios vão para um log mapeado em memória
+    // no diretório, em vez de esperar ou crescer a memória; uma thread os
+    // reenvia, em ordem, quando a fila volta a andar. Os callbacks dessas
+    // mensagens ficam na memória até a entrega; o que sobrar no disco quando o
+    // Producer é destruído é reenviado (sem callback) pelo próximo Producer
+    // aberto no mesmo diretório. Um diretório por Producer.
+    struct SpillOptions {
+        std::string directory;              // vazio: sem transbordo
+        size_t watermark_messages = 50000;  // mensagens na fila da librdkafka a partir das quais transborda
+        size_t segment_bytes = 64 << 20;    // tamanho de cada arquivo do log
+    };
+
+    struct SpillStats {
+        uint64_t spilled = 0;   // mensagens gravadas em disco desde a criação
+        uint64_t replayed = 0;  // reenviadas do disco para a librdkafka
+        uint64_t pending = 0;   // no disco, esperando reenvio
+        uint64_t recovered = 0; // encontradas no disco ao abrir o Producer
+        uint64_t lost = 0;      // recuperadas do disco e recusadas de vez (sem callback para avisar)
+        size_t segments = 0;
+    };
+
+    struct DeliveryOptions {
+        // recebe uma tarefa (um lote de callbacks) e a executa onde quiser, ex.: num thread pool.
+        // Todas as tarefas precisam rodar antes do Producer terminar de ser destruído.
+        using Executor = std::function<void(std::function<void()> task)>;
+
+        DeliveryMode mode = DeliveryMode::Inline;
+        Executor executor; // obrigatório no modo Executor
+
+        // Limite de bytes de payload enviados e ainda sem relatório de entrega
+        // (0 = sem limite, só a fila da librdkafka). Acima dele o send espera.
+        size_t max_in_flight_bytes = 0;
+
+        // Sem spill.directory, fila cheia faz o send esperar (acima). send_batch
+        // e as transações não passam pelo transbordo.
+        SpillOptions spill;
+    };
+
+    // Contadores acumulados por tópico desde a criação do Producer
+    struct TopicCounters {
+        std::string topic;
+        uint64_t messages; // mensagens aceitas pela librdkafka
+        uint64_t bytes;    // bytes de payload aceitos
+        uint64_t errors;   // falhas no enfileiramento ou na entrega
+    };
+
+    // Latência send → relatório de entrega (sucessos) de um tópico
+    struct TopicLatency {
+        std::string topic;
+        LatencySnapshot delivery;
+    };
+
+    // Mensagem completa, com chave, partição, timestamp e cabeçalhos.
+    // Tudo é referenciado, sem cópia: a librdkafka copia chave e cabeçalhos (e o
+    // valor, no send sem Buffer) ao enfileirar, então basta valer durante o send.
+    struct ProducerRecord {
+        std::string topic;
+        std::string_view value;
+        std::string_view key;        // data() == nullptr: sem chave (vazia ainda é chave)
+        int32_t partition = -1;      // -1 (ANY_PARTITION): o particionador decide pela chave
+        int64_t timestamp_ms = 0;    // 0: instante do envio
+        std::vector<Header> headers; // valor com data() == nullptr vira cabeçalho nulo
+    };
+
+    // Resultado do enfileiramento de cada mensagem de um send_batch
+    struct SendResult {
+        bool success = false;
+        std::string error;
+    };
+
+    // Falha numa operação de transação. Diz o que fazer em seguida.
+    class TransactionError : public std::runtime_error {
+    public:
+        TransactionError(const std::string& what, bool retriable, bool requires_abort, bool fatal)
+            : std::runtime_error(what), retriable_(retriable), requires_abort_(requires_abort), fatal_(fatal) {}
+
+        bool retriable() const { return retriable_; }           // a mesma chamada pode ser repetida
+        bool requires_abort() const { return requires_abort_; } // abort_transaction() e recomeçar
+        bool fatal() const { return fatal_; }                   // o Producer não serve mais: recrie
+
+    private:
+        bool retriable_;
+        bool requires_abort_;
+        bool fatal_;
+    };
+
+    // Payload com dono. A memória é entregue à librdkafka sem cópia e o deleter
+    // é chamado quando o relatório de entrega chega (ou logo, se o envio falhar).
+    class Buffer {
+    public:
+        using Deleter = void (*)(void* data, void* ctx);
+
+        Buffer() = default;
+        Buffer(void* data, size_t size, Deleter deleter, void* ctx = nullptr);
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        ~Buffer();
+
+        static Buffer from_malloc(void* data, size_t size);
+        static Buffer from_string(std::string&& str);
+        static Buffer from_array(std::unique_ptr<char[]> data, size_t size);
+
+        void* data() const { return data_; }
+        size_t size() const { return size_; }
+        explicit operator bool() const { return data_ != nullptr || deleter_ != nullptr; }
+
+    private:
+        void reset();
+
+        void* data_ = nullptr;
+        size_t size_ = 0;
+        Deleter deleter_ = nullptr;
+        void* ctx_ = nullptr;
+    };
 
 class Producer {
 public:
 
-#ifdef ASYNC_MODE
+    // Chamado com o relatório de entrega. Se a mensagem nem for aceita pela
+    // librdkafka (ex.: tópico inválido), é chamado na hora, na thread de quem enviou.
     using DeliveryCallback = std::function<void(const DeliveryReport&)>;   
-#else
-    using DeliveryCallback = std::function<void(bool success, const std::string& error)>;
-#endif
+
     Producer(const std::string& brokers, const std::string& ssl_ca   = "", const std::string& ssl_cert = "", const std::string& ssl_key  = "");
+    Producer(const std::string& brokers, const DeliveryOptions& delivery,
+             const std::string& ssl_ca   = "", const std::string& ssl_cert = "", const std::string& ssl_key  = "");
+    // configuração completa: SSL, linger.ms, batch.size, compressão, perfis...
+    explicit Producer(const ClientConfig& config, const DeliveryOptions& delivery = DeliveryOptions());
     ~Producer();
 
-    // permite configurar SSL, timeouts, etc
-    //void setConfig(const std::string& key, const std::string& value);    
-
+    // Todos os send esperam enquanto não houver espaço (fila da librdkafka cheia
+    // ou max_in_flight_bytes atingido), acordando a cada relatório de entrega.
     void send(const std::string& topic, const std::string& message, DeliveryCallback callback = nullptr);
+    // literais também são copiados (e evitam ambiguidade com a versão string_view)
+    void send(const std::string& topic, const char* message, DeliveryCallback callback = nullptr);
+
+    // --- envio sem cópia: o Producer assume a memória e a libera após a entrega ---
+    void send(const std::string& topic, std::string&& message, DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, std::unique_ptr<char[]> data, size_t size, DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, Buffer buffer, DeliveryCallback callback = nullptr);
+
+    // sem cópia e sem posse: o chamador garante que 'message' continua válida
+    // até o relatório de entrega chegar (ou até o flush() retornar)
+    void send(const std::string& topic, std::string_view message, DeliveryCallback callback = nullptr);
+
+    // Com chave, partição, timestamp e cabeçalhos; o valor é copiado...
+    void send(const ProducerRecord& record, DeliveryCallback callback = nullptr);
+    // ...ou vem do Buffer, sem cópia (record.value é ignorado)
+    void send(const ProducerRecord& record, Buffer value, DeliveryCallback callback = nullptr);
 
-#ifdef ASYNC_MODE
+    // --- envio com prazo (payload copiado) ---
+    // Sem espaço, try_send desiste na hora e send_for depois de 'timeout'.
+    // Quando o resultado é uma falha, o callback não é chamado.
+    SendResult try_send(const std::string& topic, std::string_view message, DeliveryCallback callback = nullptr);
+    SendResult send_for(const std::string& topic, std::string_view message,
+                        std::chrono::milliseconds timeout, DeliveryCallback callback = nullptr);
+
+    // Qualquer partição (decidida pelo particionador)
+    static constexpr int32_t ANY_PARTITION = -1;
+
+    // Enfileira um lote inteiro com uma única chamada à librdkafka.
+    // Devolve um resultado por mensagem, na mesma ordem da entrada, para que
+    // somente as que falharam sejam reenviadas. O callback é chamado por mensagem.
+    // Só espera pelo max_in_flight_bytes; fila cheia aparece nos resultados.
+    std::vector<SendResult> send_batch(const std::string& topic,
+                                       const std::vector<std::string>& messages,
+                                       int32_t partition = ANY_PARTITION,
+                                       DeliveryCallback callback = nullptr);
+
+    // Versão sem cópia sobre um intervalo contíguo de views: assim como no send
+    // com string_view, a memória precisa continuar válida até a entrega.
+    std::vector<SendResult> send_batch(const std::string& topic,
+                                       const std::string_view* messages,
+                                       size_t count,
+                                       int32_t partition = ANY_PARTITION,
+                                       DeliveryCallback callback = nullptr);
+
+    // Mantidos por compatibilidade: equivalem ao send (o modo de entrega é do Producer)
     void send_async(const std::string& topic, const std::string& message, DeliveryCallback callback);
-#endif
+    void send_async(const std::string& topic, const char* message, DeliveryCallback callback);
+    void send_async(const std::string& topic, std::string&& message, DeliveryCallback callback);
+    void send_async(const std::string& topic, Buffer buffer, DeliveryCallback callback);
+    void send_async(const std::string& topic, std::string_view message, DeliveryCallback callback);
+
+    // Serve os relatórios de entrega pendentes nos modos Inline e EventLoop (o
+    // send já faz isso sem bloquear). Nos modos com thread não faz nada.
+    // Retorna quantos eventos foram servidos.
+    int poll(int timeout_ms = 0);
+
+    // --- integração com event loop (DeliveryMode::EventLoop) ---
+    // eventfd que fica legível quando há relatórios a servir; -1 nos outros modos
+    int fd() const;
+    // Serve, sem bloquear, todos os relatórios prontos e rearma o fd.
+    // Retorna quantos relatórios foram servidos.
+    size_t drain();
 
+    // Espera as mensagens pendentes serem entregues e, no modo Executor,
+    // os callbacks já despachados terminarem.
     void flush(int timeout_ms = 1000);
 
+    DeliveryMode delivery_mode() const;
+
+    // contadores do transbordo em disco (zerados sem SpillOptions::directory)
+    SpillStats spill_stats() const;
+
+    // --- transações (requer ClientConfig::transactional_id) ---
+    // Erros viram TransactionError. init_transactions uma vez, antes do
+    // primeiro begin; ela também cerca instâncias antigas com o mesmo id.
+    void init_transactions(int timeout_ms = 30000);
+    void begin_transaction();
+    // Inclui na transação as posições atuais do consumer (offset seguinte ao
+    // da última mensagem entregue), para o commit sair junto com as mensagens
+    // produzidas. O consumer não deve commitar sozinho: sem ack() e com
+    // enable.auto.commit=false.
+    void send_offsets_to_transaction(const Consumer& consumer, int timeout_ms = 30000);
+    // Espera as mensagens da transação serem entregues e a confirma
+    void commit_transaction(int timeout_ms = 30000);
+    void abort_transaction(int timeout_ms = 30000);
+
+    // snapshot dos contadores de cada tópico já usado por este Producer
+    std::vector<TopicCounters> topic_counters() const;
+
+    // p50/p99/p999 por tópico do tempo entre o send e o relatório de entrega
+    std::vector<TopicLatency> delivery_latency() const;
+
+    // Últimas estatísticas da librdkafka (requer statistics.interval.ms > 0).
+    // O JSON é convertido aqui, sob demanda, e não no caminho de envio.
+    ClientStats stats() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
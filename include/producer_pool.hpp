@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "producer.hpp"
+
+namespace mykafka {
+
+struct PoolOptions {
+    // Como cada envio escolhe o Producer (shard)
+    enum class Routing {
+        ThreadAffinity, // cada thread fica sempre no mesmo shard: sem disputa entre threads
+        Partition,      // por tópico+partição explícita ou tópico+chave: a ordem por chave
+                        // (e por partição explícita) se mantém; sem nenhuma das duas
+                        // (inclusive send(topic, ...)), pelo tópico: todas as mensagens
+                        // sem chave de um tópico passam pelo mesmo shard
+    };
+
+    size_t shards = 4;
+    Routing routing = Routing::Partition;
+};
+
+// N Producers independentes (um rd_kafka_t, fila interna e thread de entrega
+// cada), para quando muitas threads enviam ao mesmo tempo e um único Producer
+// vira o gargalo. Todos usam a mesma ClientConfig e as mesmas DeliveryOptions;
+// com spill, cada shard usa o subdiretório shard-<i> (mantenha o número de
+// shards entre execuções para o que ficou no disco ser reenviado).
+// Com transações, use um Producer por transactional.id, e não o pool: com
+// transactional.id o construtor lança std::invalid_argument.
+class ProducerPool {
+public:
+    explicit ProducerPool(const ClientConfig& config, const PoolOptions& options = PoolOptions(),
+                          const DeliveryOptions& delivery = DeliveryOptions());
+    // Entrega o que falta em todos os shards ao mesmo tempo (até 3 s, como o Producer)
+    ~ProducerPool();
+
+    ProducerPool(const ProducerPool&) = delete;
+    ProducerPool& operator=(const ProducerPool&) = delete;
+
+    // Mesma semântica de cópia/posse dos send do Producer. Sem record não há
+    // chave: o shard segue o roteamento como um record só com o tópico.
+    void send(const std::string& topic, const std::string& message, Producer::DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, const char* message, Producer::DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, std::string&& message, Producer::DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, Buffer buffer, Producer::DeliveryCallback callback = nullptr);
+    void send(const std::string& topic, std::string_view message, Producer::DeliveryCallback callback = nullptr);
+    void send(const ProducerRecord& record, Producer::DeliveryCallback callback = nullptr);
+    void send(const ProducerRecord& record, Buffer value, Producer::DeliveryCallback callback = nullptr);
+
+    // Flush de todos os shards em paralelo: espera no máximo 'timeout_ms' no total.
+    // No modo Inline os callbacks rodam nas threads do flush, um shard por thread.
+    void flush(int timeout_ms = 1000);
+
+    size_t shards() const { return shards_.size(); }
+    // acesso direto, ex.: fd()/drain() de cada shard no modo EventLoop
+    Producer& shard(size_t index) { return *shards_[index]; }
+    // o shard que o roteamento escolheria para o record
+    size_t shard_of(const ProducerRecord& record) const;
+
+    // contadores somados de todos os shards, por tópico
+    std::vector<TopicCounters> topic_counters() const;
+    // estatísticas de cada shard (cada um tem o próprio client.id/nome)
+    std::vector<ClientStats> stats() const;
+
+private:
+    size_t by_thread() const;
+    size_t by_topic(std::string_view topic) const; // sem chave nem partição
+
+    PoolOptions options_;
+    std::vector<std::unique_ptr<Producer>> shards_;
+};
+
+} // namespace mykafka
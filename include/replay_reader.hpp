@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include "message_view.hpp"
+#include "client_config.hpp"
+
+namespace mykafka {
+
+// Intervalo [start_offset, end_offset) de uma partição
+struct PartitionRange {
+    std::string topic;
+    int32_t partition = 0;
+    int64_t start_offset = 0;
+    int64_t end_offset = 0; // exclusivo
+};
+
+struct ReplayOptions {
+    size_t threads = 0;                          // 0 = std::thread::hardware_concurrency()
+    int fetch_max_bytes = 64 << 20;              // por requisição de fetch
+    int partition_fetch_bytes = 8 << 20;         // por partição, por fetch
+    int queued_max_messages_kbytes = 256 << 10;  // pré-busca por thread
+    size_t max_batch = 4096;                     // mensagens por consume_batch
+};
+
+// Leitura de uma janela fechada de offsets, sem grupo: as partições são
+// atribuídas direto (assign) e divididas entre N threads, cada uma com seu
+// próprio handle da librdkafka. Nada é commitado. Cada partição para
+// exatamente no seu end_offset, e a ordem dentro dela é preservada.
+//
+//   ReplayReader reader(cfg);
+//   auto ranges = reader.resolve("pedidos", {}, inicio_ms, fim_ms);
+//   reader.run(ranges, [](const MessageView& m) { reprocessa(m); });
+class ReplayReader {
+public:
+    // Chamado nas threads de leitura, em paralelo entre partições diferentes.
+    // A view vale durante a chamada (ou use retain()).
+    using Handler = std::function<void(const MessageView& message)>;
+
+    // Só brokers/SSL/etc. são usados: group.id, commit e reset são ajustados aqui
+    explicit ReplayReader(const ClientConfig& config, const ReplayOptions& options = ReplayOptions());
+    ~ReplayReader();
+
+    // Converte timestamps (ms desde a época) em offsets: do primeiro com
+    // timestamp >= from_ms ao primeiro com timestamp >= to_ms, exclusivo.
+    // 'partitions' vazio = todas as do tópico. Sem mensagem depois do instante,
+    // o limite é o fim atual da partição. Usa o timestamp gravado na mensagem:
+    // com CreateTime fora de ordem os limites são aproximados.
+    std::vector<PartitionRange> resolve(const std::string& topic,
+                                        const std::vector<int32_t>& partitions,
+                                        int64_t from_ms, int64_t to_ms,
+                                        int timeout_ms = 10000);
+
+    // Lê todos os intervalos e retorna quando terminarem (ou depois de stop()).
+    // Uma exceção do handler interrompe a leitura e é relançada aqui.
+    // Retorna quantas mensagens foram entregues ao handler.
+    uint64_t run(const std::vector<PartitionRange>& ranges, Handler handler);
+
+    // Interrompe o run() em andamento, ou o próximo, se ainda não começou; pode
+    // ser chamado de qualquer thread. Depois dele, run() retorna sem ler nada.
+    void stop();
+
+    uint64_t processed() const;       // mensagens entregues no run() atual
+    size_t partitions_left() const;   // partições que ainda não chegaram ao fim
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace mykafka
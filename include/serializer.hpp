@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "buffer_pool.hpp"
+
+namespace mykafka {
+
+// Traits resolvidos em tempo de compilação pelos TypedProducer/TypedConsumer.
+//
+// Serializer<T> precisa de:
+//     static void serialize(const T& value, PooledBuffer& out); // escreve no fim de 'out'
+// e, opcionalmente, para reservar de uma vez:
+//     static size_t size_hint(const T& value);
+//
+// Deserializer<T> precisa de:
+//     static void deserialize(std::string_view payload, T& out); // payload inválido: exceção
+// 'out' é reaproveitado entre mensagens (capacidade de strings/vetores não se perde).
+//
+// Especialize para os seus tipos ou passe a classe como parâmetro do template.
+template <typename T, typename Enable = void>
+struct Serializer;
+
+template <typename T, typename Enable = void>
+struct Deserializer;
+
+template <>
+struct Serializer<std::string> {
+    static size_t size_hint(const std::string& value) { return value.size(); }
+    static void serialize(const std::string& value, PooledBuffer& out) { out.append(value); }
+};
+
+template <>
+struct Deserializer<std::string> {
+    static void deserialize(std::string_view payload, std::string& out) { out.assign(payload); }
+};
+
+// Cópia byte a byte, na ordem de bytes da máquina: só entre máquinas iguais
+template <typename T>
+struct PodSerializer {
+    static_assert(std::is_trivially_copyable<T>::value, "PodSerializer requer tipo trivialmente copiável");
+    static size_t size_hint(const T&) { return sizeof(T); }
+    static void serialize(const T& value, PooledBuffer& out) { out.append(&value, sizeof(T)); }
+};
+
+template <typename T>
+struct PodDeserializer {
+    static_assert(std::is_trivially_copyable<T>::value, "PodDeserializer requer tipo trivialmente copiável");
+    static void deserialize(std::string_view payload, T& out) {
+        if (payload.size() != sizeof(T))
+            throw std::runtime_error("Payload com " + std::to_string(payload.size()) +
+                                     " bytes, esperado " + std::to_string(sizeof(T)));
+        std::memcpy(&out, payload.data(), sizeof(T));
+    }
+};
+
+template <typename T>
+struct Serializer<T, std::enable_if_t<std::is_arithmetic<T>::value>> : PodSerializer<T> {};
+
+template <typename T>
+struct Deserializer<T, std::enable_if_t<std::is_arithmetic<T>::value>> : PodDeserializer<T> {};
+
+namespace detail {
+
+template <typename S, typename T, typename = void>
+struct has_size_hint : std::false_type {};
+
+template <typename S, typename T>
+struct has_size_hint<S, T, std::void_t<decltype(S::size_hint(std::declval<const T&>()))>> : std::true_type {};
+
+} // namespace detail
+
+} // namespace mykafka
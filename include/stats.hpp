@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace mykafka {
+
+// Snapshot tipado do JSON de estatísticas da librdkafka (statistics.interval.ms).
+// Tempos de RTT em microssegundos e de throttle em milissegundos, como na librdkafka.
+
+struct BrokerStats {
+    std::string name;
+    int32_t nodeid = -1;
+    std::string state;
+    int64_t outbuf_cnt = 0;   // requisições esperando para serem enviadas
+    int64_t waitresp_cnt = 0; // requisições em voo, aguardando resposta
+    int64_t tx = 0;
+    int64_t rx = 0;
+    int64_t rtt_avg_us = 0;
+    int64_t rtt_p99_us = 0;
+    int64_t throttle_avg_ms = 0;
+    int64_t throttle_max_ms = 0;
+};
+
+struct TopicStats {
+    std::string topic;
+    int64_t batchsize_avg = 0; // bytes por MessageSet enviado
+    int64_t batchsize_p99 = 0;
+    int64_t batchcnt_avg = 0;  // mensagens por MessageSet enviado
+    int64_t batchcnt_p99 = 0;
+};
+
+struct PartitionStats {
+    std::string topic;
+    int32_t partition = -1;
+    int32_t leader = -1;
+    int64_t msgq_cnt = 0;      // producer: mensagens aguardando na fila da partição
+    int64_t xmit_msgq_cnt = 0;
+    int64_t fetchq_cnt = 0;    // consumer: mensagens pré-buscadas
+    int64_t fetchq_size = 0;
+    int64_t hi_offset = -1;
+    int64_t committed_offset = -1;
+    int64_t consumer_lag = -1;
+};
+
+struct ClientStats {
+    std::string name;
+    std::string type;   // "producer" | "consumer"
+    int64_t ts_us = 0;  // relógio monotônico interno da librdkafka
+    int64_t replyq = 0; // eventos esperando poll
+    int64_t msg_cnt = 0;  // mensagens nas filas internas do producer
+    int64_t msg_size = 0;
+    int64_t msg_max = 0;
+    int64_t msg_size_max = 0;
+    int64_t tx = 0;
+    int64_t rx = 0;
+    int64_t txmsgs = 0;
+    int64_t rxmsgs = 0;
+
+    std::vector<BrokerStats> brokers;
+    std::vector<TopicStats> topics;
+    std::vector<PartitionStats> partitions;
+
+    // false até o primeiro callback de estatísticas
+    bool valid() const { return !name.empty(); }
+};
+
+// Converte o JSON da librdkafka; lança std::runtime_error se estiver malformado
+ClientStats parse_stats(std::string_view json);
+
+// Formato texto do Prometheus (exposition format 0.0.4), métricas com prefixo 'prefix'
+std::string to_prometheus(const ClientStats& stats, const std::string& prefix = "kafka");
+
+} // namespace mykafka
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include "client_config.hpp"
+
+namespace mykafka {
+
+struct TableOptions {
+    std::string snapshot_path;          // vazio = sem snapshot
+    int snapshot_interval_ms = 60000;   // só se algo mudou desde o último
+    size_t initial_slots = 1 << 16;     // capacidade inicial da tabela (cresce sozinha)
+    size_t max_batch = 4096;            // mensagens por poll
+};
+
+// Tabela chave → último valor, materializada a partir de tópicos compactados.
+// Lê todas as partições (assign direto, sem grupo: cada instância tem a tabela
+// inteira) e aplica cada mensagem: payload nulo (tombstone) remove a chave;
+// mensagens sem chave são ignoradas. Com vários tópicos, as chaves se misturam.
+//
+// Com snapshot_path, a tabela e os offsets consumidos são gravados
+// periodicamente num arquivo mapeado em memória (troca atômica por rename). Na
+// próxima vez a tabela é carregada dele e só o resto dos tópicos é consumido;
+// snapshot ausente ou inválido faz ler desde o início.
+//
+// poll() deve ser chamado sempre da mesma thread; get() e os demais podem ser
+// chamados de qualquer thread, ao mesmo tempo que o poll.
+class TableConsumer {
+public:
+    TableConsumer(const ClientConfig& config, const std::vector<std::string>& topics,
+                  const TableOptions& options = TableOptions());
+    // grava um último snapshot, se houver mudanças
+    ~TableConsumer();
+
+    // Aplica o que chegou; retorna quantas mensagens foram aplicadas
+    size_t poll(int timeout_ms = 1000);
+
+    // Todas as partições chegaram, ao menos uma vez, ao fim do que existia:
+    // a tabela já reflete os tópicos (até o momento da leitura)
+    bool caught_up() const;
+
+    std::optional<std::string> get(std::string_view key) const;
+    // reaproveita a memória de 'value'; false se a chave não existir
+    bool get(std::string_view key, std::string& value) const;
+    bool contains(std::string_view key) const;
+    size_t size() const;
+    size_t memory_bytes() const;
+
+    // Grava o snapshot agora (requer snapshot_path). Erros viram std::runtime_error.
+    void snapshot();
+    // chaves carregadas do snapshot na abertura (0 = começou do zero)
+    size_t restored() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace mykafka
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "producer.hpp"
+#include "consumer.hpp"
+#include "serializer.hpp"
+
+namespace mykafka {
+
+// Envia T serializado direto num bloco do BufferPool, entregue à librdkafka
+// sem cópia: nenhuma std::string intermediária. O modo de entrega, o
+// backpressure etc. são os do Producer por baixo.
+template <typename T, typename S = Serializer<T>>
+class TypedProducer {
+public:
+    using DeliveryCallback = Producer::DeliveryCallback;
+
+    // Várias instâncias podem dividir um mesmo pool (cópias do BufferPool)
+    explicit TypedProducer(Producer& producer, BufferPool pool = BufferPool())
+        : producer_(producer), pool_(std::move(pool)) {}
+
+    void send(const std::string& topic, const T& value, DeliveryCallback callback = nullptr) {
+        producer_.send(topic, encode(value), std::move(callback));
+    }
+
+    // Chave, partição, timestamp e cabeçalhos do record; o valor é 'value'
+    void send(const ProducerRecord& record, const T& value, DeliveryCallback callback = nullptr) {
+        producer_.send(record, encode(value), std::move(callback));
+    }
+
+    // Serializa sem enviar (ex.: para um send_batch próprio)
+    Buffer encode(const T& value) {
+        PooledBuffer out = pool_.acquire(hint(value));
+        S::serialize(value, out);
+        return out.release();
+    }
+
+    Producer& producer() { return producer_; }
+    BufferPool& pool() { return pool_; }
+
+private:
+    static size_t hint(const T& value) {
+        if constexpr (detail::has_size_hint<S, T>::value)
+            return S::size_hint(value);
+        else
+            return 0;
+    }
+
+    Producer& producer_;
+    BufferPool pool_;
+};
+
+// Entrega T desserializado direto do payload da librdkafka, sem std::string
+// intermediária. O objeto passado ao callback é reaproveitado entre mensagens:
+// copie o que precisar guardar.
+template <typename T, typename D = Deserializer<T>>
+class TypedConsumer {
+public:
+    using Callback = std::function<void(const T& value, const MessageView& message)>;
+    // payload que o Deserializer rejeitou; no modo ack, confirme aqui para não travar o commit
+    using ErrorCallback = std::function<void(const MessageView& message, const std::exception& error)>;
+
+    explicit TypedConsumer(Consumer& consumer, ErrorCallback on_error = nullptr)
+        : consumer_(consumer), on_error_(std::move(on_error)) {}
+
+    void poll(const Callback& callback, int timeout_ms = 1000) {
+        consumer_.poll(Consumer::ViewCallback([this, &callback](const MessageView& message) {
+            deliver(callback, message);
+        }), timeout_ms);
+    }
+
+    size_t poll_batch(const Callback& callback, size_t max_messages = 1000, int timeout_ms = 1000) {
+        return consumer_.poll_batch([this, &callback](const MessageBatch& batch) {
+            for (const MessageView& message : batch)
+                deliver(callback, message);
+        }, max_messages, timeout_ms);
+    }
+
+    size_t drain(const Callback& callback, size_t max_messages = SIZE_MAX) {
+        return consumer_.drain([this, &callback](const MessageView& message) {
+            deliver(callback, message);
+        }, max_messages);
+    }
+
+    Consumer& consumer() { return consumer_; }
+    // mensagens que o Deserializer rejeitou
+    uint64_t decode_errors() const { return decode_errors_; }
+
+private:
+    void deliver(const Callback& callback, const MessageView& message) {
+        try {
+            D::deserialize(message.payload(), value_);
+        } catch (const std::exception& e) {
+            ++decode_errors_;
+            if (on_error_)
+                on_error_(message, e);
+            else
+                std::cerr << "Erro desserializando " << message.topic() << "[" << message.partition()
+                          << "]@" << message.offset() << ": " << e.what() << std::endl;
+            return;
+        }
+        callback(value_, message);
+    }
+
+    Consumer& consumer_;
+    ErrorCallback on_error_;
+    T value_{};
+    uint64_t decode_errors_ = 0;
+};
+
+} // namespace mykafka
@@ -0,0 +1,80 @@
+#include "buffer_pool.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace mykafka {
+
+namespace detail {
+
+struct PoolState {
+    std::mutex mutex;
+    std::vector<PoolBlock*> free;
+    size_t max_cached;
+    size_t max_block_bytes;
+
+    ~PoolState() {
+        for (PoolBlock* block : free)
+            delete block;
+    }
+};
+
+void return_block(void*, void* ctx) {
+    auto* block = static_cast<PoolBlock*>(ctx);
+    // o último bloco a voltar pode ser quem destrói o pool
+    std::shared_ptr<PoolState> owner = std::move(block->owner);
+    block->size = 0;
+
+    if (block->capacity <= owner->max_block_bytes) {
+        std::lock_guard<std::mutex> lock(owner->mutex);
+        if (owner->free.size() < owner->max_cached) {
+            owner->free.push_back(block);
+            return;
+        }
+    }
+    delete block;
+}
+
+} // namespace detail
+
+void PooledBuffer::grow(size_t needed) {
+    // dobra para amortizar; o bloco guarda a capacidade entre usos
+    size_t capacity = std::max({needed, block_->capacity * 2, size_t(256)});
+    std::unique_ptr<char[]> data(new char[capacity]);
+    if (block_->size > 0)
+        std::memcpy(data.get(), block_->data.get(), block_->size);
+    block_->data = std::move(data);
+    block_->capacity = capacity;
+}
+
+BufferPool::BufferPool(size_t max_cached, size_t max_block_bytes)
+    : state_(std::make_shared<detail::PoolState>())
+{
+    state_->max_cached = max_cached;
+    state_->max_block_bytes = max_block_bytes;
+}
+
+PooledBuffer BufferPool::acquire(size_t capacity_hint) {
+    detail::PoolBlock* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->free.empty()) {
+            block = state_->free.back();
+            state_->free.pop_back();
+        }
+    }
+    if (!block)
+        block = new detail::PoolBlock();
+    block->owner = state_;
+
+    PooledBuffer buffer(block);
+    buffer.reserve(capacity_hint);
+    return buffer;
+}
+
+size_t BufferPool::cached() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->free.size();
+}
+
+} // namespace mykafka
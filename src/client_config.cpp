@@ -0,0 +1,234 @@
+#include "client_config.hpp"
+#include <librdkafka/rdkafka.h>
+#include <stdexcept>
+
+namespace mykafka {
+
+ClientConfig::ClientConfig(const std::string& brokers) {
+    this->brokers(brokers);
+}
+
+ClientConfig& ClientConfig::profile(Profile p) {
+    switch (p) {
+        case Profile::Default:
+            break;
+
+        case Profile::LowLatency:
+            // producer: cada mensagem sai assim que chega
+            set("linger.ms", "0", Scope::Producer);
+            set("batch.num.messages", "1000", Scope::Producer);
+            compression(Compression::None);
+            // consumer: o broker responde ao primeiro byte disponível
+            fetch_min_bytes(1);
+            fetch_wait_max_ms(10);
+            set("socket.nagle.disable", "true");
+            break;
+
+        case Profile::HighThroughput:
+            // producer: espera um pouco para encher lotes grandes e comprimidos
+            linger_ms(50);
+            batch_size(1024 * 1024);
+            batch_num_messages(100000);
+            compression(Compression::Lz4);
+            queue_buffering_max_kbytes(2 * 1024 * 1024);
+            queue_buffering_max_messages(1000000);
+            // consumer: fetches grandes e uma fila de pré-busca folgada
+            fetch_min_bytes(1024 * 1024);
+            fetch_wait_max_ms(100);
+            fetch_max_bytes(64 * 1024 * 1024);
+            queued_max_messages_kbytes(256 * 1024);
+            break;
+
+        case Profile::MemoryConstrained:
+            // producer: limita o que fica retido em memória
+            linger_ms(5);
+            batch_size(64 * 1024);
+            queue_buffering_max_kbytes(16 * 1024);
+            queue_buffering_max_messages(10000);
+            compression(Compression::Lz4);
+            // consumer: pré-busca pequena por partição
+            fetch_max_bytes(4 * 1024 * 1024);
+            set("max.partition.fetch.bytes", "262144", Scope::Consumer);
+            queued_max_messages_kbytes(4 * 1024);
+            set("queued.min.messages", "1000", Scope::Consumer);
+            break;
+    }
+    return *this;
+}
+
+// ---------- comuns ----------
+
+ClientConfig& ClientConfig::brokers(const std::string& brokers) {
+    return set("bootstrap.servers", brokers);
+}
+
+ClientConfig& ClientConfig::client_id(const std::string& id) {
+    return set("client.id", id);
+}
+
+ClientConfig& ClientConfig::ssl(const std::string& ca, const std::string& cert, const std::string& key) {
+    if (!ca.empty()) {
+        set("security.protocol", "SSL");
+        // Desabilitar a validação de hostname se você usou IP no certificado.
+        // Certificado do broker usa apenas o IP no CN/SAN e nao um hostname valido. 
+        set("ssl.endpoint.identification.algorithm", "none");
+        set("ssl.ca.location", ca);
+    }
+    if (!cert.empty())
+        set("ssl.certificate.location", cert);
+    if (!key.empty())
+        set("ssl.key.location", key);
+    return *this;
+}
+
+ClientConfig& ClientConfig::statistics_interval_ms(int ms) {
+    return set("statistics.interval.ms", std::to_string(ms));
+}
+
+// ---------- producer ----------
+
+ClientConfig& ClientConfig::linger_ms(int ms) {
+    return set("linger.ms", std::to_string(ms), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::batch_size(int bytes) {
+    return set("batch.size", std::to_string(bytes), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::batch_num_messages(int count) {
+    return set("batch.num.messages", std::to_string(count), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::compression(Compression type) {
+    const char* value = "none";
+    switch (type) {
+        case Compression::None:   value = "none";   break;
+        case Compression::Gzip:   value = "gzip";   break;
+        case Compression::Snappy: value = "snappy"; break;
+        case Compression::Lz4:    value = "lz4";    break;
+        case Compression::Zstd:   value = "zstd";   break;
+    }
+    return set("compression.type", value, Scope::Producer);
+}
+
+ClientConfig& ClientConfig::queue_buffering_max_kbytes(int kbytes) {
+    return set("queue.buffering.max.kbytes", std::to_string(kbytes), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::queue_buffering_max_messages(int count) {
+    return set("queue.buffering.max.messages", std::to_string(count), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::acks(int acks) {
+    return set("acks", std::to_string(acks), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::idempotence(bool enabled) {
+    return set("enable.idempotence", enabled ? "true" : "false", Scope::Producer);
+}
+
+ClientConfig& ClientConfig::max_in_flight(int requests) {
+    return set("max.in.flight.requests.per.connection", std::to_string(requests), Scope::Producer);
+}
+
+ClientConfig& ClientConfig::transactional_id(const std::string& id) {
+    return set("transactional.id", id, Scope::Producer);
+}
+
+ClientConfig& ClientConfig::partitioner(Partitioner type, int sticky_linger_ms) {
+    // propriedade de tópico: vai para a configuração padrão dos tópicos
+    switch (type) {
+        case Partitioner::Murmur2:
+            set("partitioner", "murmur2_random", Scope::Producer);
+            return set("sticky.partitioning.linger.ms", "0", Scope::Producer);
+        case Partitioner::ConsistentRandom:
+            set("partitioner", "consistent_random", Scope::Producer);
+            return set("sticky.partitioning.linger.ms", "0", Scope::Producer);
+        case Partitioner::Sticky:
+            set("partitioner", "murmur2_random", Scope::Producer);
+            return set("sticky.partitioning.linger.ms", std::to_string(sticky_linger_ms), Scope::Producer);
+    }
+    return *this;
+}
+
+// ---------- consumer ----------
+
+ClientConfig& ClientConfig::group_id(const std::string& id) {
+    return set("group.id", id, Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::auto_offset_reset(const std::string& reset) {
+    return set("auto.offset.reset", reset, Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::assignor(Assignor type) {
+    switch (type) {
+        case Assignor::Range:
+            return set("partition.assignment.strategy", "range", Scope::Consumer);
+        case Assignor::RoundRobin:
+            return set("partition.assignment.strategy", "roundrobin", Scope::Consumer);
+        case Assignor::CooperativeSticky:
+            return set("partition.assignment.strategy", "cooperative-sticky", Scope::Consumer);
+    }
+    return *this;
+}
+
+ClientConfig& ClientConfig::isolation_level(const std::string& level) {
+    return set("isolation.level", level, Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::group_instance_id(const std::string& id) {
+    return set("group.instance.id", id, Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::fetch_min_bytes(int bytes) {
+    return set("fetch.min.bytes", std::to_string(bytes), Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::fetch_wait_max_ms(int ms) {
+    return set("fetch.wait.max.ms", std::to_string(ms), Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::fetch_max_bytes(int bytes) {
+    return set("fetch.max.bytes", std::to_string(bytes), Scope::Consumer);
+}
+
+ClientConfig& ClientConfig::queued_max_messages_kbytes(int kbytes) {
+    return set("queued.max.messages.kbytes", std::to_string(kbytes), Scope::Consumer);
+}
+
+// ---------- genérico ----------
+
+ClientConfig& ClientConfig::set(const std::string& key, const std::string& value, Scope scope) {
+    for (auto& e : entries_) {
+        if (e.key == key) {
+            e.value = value;
+            e.scope = scope;
+            return *this;
+        }
+    }
+    entries_.push_back({key, value, scope});
+    return *this;
+}
+
+std::string ClientConfig::get(const std::string& key) const {
+    for (const auto& e : entries_) {
+        if (e.key == key)
+            return e.value;
+    }
+    return "";
+}
+
+void ClientConfig::apply(rd_kafka_conf_t* conf, Scope role) const {
+    char errstr[512];
+    for (const auto& e : entries_) {
+        if (e.scope != Scope::Common && e.scope != role)
+            continue;
+        if (rd_kafka_conf_set(conf, e.key.c_str(), e.value.c_str(),
+                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            throw std::runtime_error("Config '" + e.key + "=" + e.value + "': " + errstr);
+        }
+    }
+}
+
+} // namespace mykafka
@@ -1,7 +1,16 @@
 #include "consumer.hpp"
+#include "stats_collector.hpp"
+#include "offset_tracker.hpp"
+#include "rebalance.hpp"
 #include <librdkafka/rdkafka.h>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace mykafka {
 
@@ -10,49 +19,81 @@ public:
     rd_kafka_t* rk;
     rd_kafka_conf_t* conf;
     rd_kafka_topic_partition_list_t* topic_list;
+    rd_kafka_queue_t* queue{};   // fila do consumer, usada pelo poll_batch
+    MessageBatch scratch;        // lote reaproveitado pelo poll_batch com callback
+    int event_fd = -1;           // criado pelo fd(), sinalizado pela fila do consumer
+    std::function<void()> ready_callback; // set_ready_callback()
+    RebalanceHooks hooks;
+    MessageFilter filter;         // set_filter(); vazio = tudo passa
+    bool filtering = false;
+    std::atomic<uint64_t> filter_passed{0};
+    std::atomic<uint64_t> filter_dropped{0};
+    StatsCollector statistics;
 
-    Impl(const std::string& brokers,
-        const std::string& groupId,
-        const std::vector<std::string>& topics,
-        const std::string& ssl_ca,
-        const std::string& ssl_cert,
-        const std::string& ssl_key)
-    {
-        char errstr[512];
+    LatencyHistogram processing;  // entrega ao callback → fim do callback
+    LatencyHistogram end_to_end;  // timestamp da mensagem → fim do callback
 
-        conf = rd_kafka_conf_new();
+    // o que precisa ser lido antes do callback (ele pode reter e liberar a mensagem)
+    // (rd_kafka_message_latency só vale para mensagens produzidas: no consumer é -1)
+    struct Receipt {
+        int64_t timestamp_ms; // timestamp da mensagem, -1 se não houver
+    };
+    std::vector<Receipt> receipts; // reaproveitado entre lotes
 
-        // brokers
-        if (rd_kafka_conf_set(conf, "bootstrap.servers", brokers.c_str(),
-                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
-            throw std::runtime_error(errstr);
-        }
+    static Receipt receipt_of(const rd_kafka_message_t* msg) {
+        return {rd_kafka_message_timestamp(msg, nullptr)};
+    }
 
-        // group.id
-        if (rd_kafka_conf_set(conf, "group.id", groupId.c_str(),
-                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
-            throw std::runtime_error(errstr);
+    void record_latency(std::chrono::steady_clock::time_point polled,
+                        const Receipt* items, size_t count) {
+        using namespace std::chrono;
+        int64_t handling_us = duration_cast<microseconds>(steady_clock::now() - polled).count();
+        int64_t now_ms = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+
+        for (size_t i = 0; i < count; ++i) {
+            const Receipt& r = items[i];
+            processing.record(static_cast<uint64_t>(handling_us));
+            // relógios de máquinas diferentes: diferença negativa é descartada
+            if (r.timestamp_ms > 0 && now_ms >= r.timestamp_ms)
+                end_to_end.record(static_cast<uint64_t>(now_ms - r.timestamp_ms) * 1000);
         }
+    }
 
-        // auto offset reset
-        rd_kafka_conf_set(conf, "auto.offset.reset", "earliest",
-                          nullptr, 0);
+    // ack(): offsets confirmados e commits agrupados
+    AckOptions acks;
+    OffsetTracker tracker;
+    std::atomic<size_t> unflushed_acks{0};
+    std::mutex commit_mutex;
+    std::chrono::steady_clock::time_point last_commit = std::chrono::steady_clock::now();
 
-        // --- SSL / TLS ---
-        if (!ssl_ca.empty()) {
-            rd_kafka_conf_set(conf, "security.protocol", "SSL", nullptr, 0);
-            // Desabilitar a validação de hostname se você usou IP no certificado.
-            // Certificado do broker usa apenas o IP no CN/SAN e nao um hostname valido. 
-            rd_kafka_conf_set(conf, "ssl.endpoint.identification.algorithm", "none", nullptr, 0);
-            rd_kafka_conf_set(conf, "ssl.ca.location", ssl_ca.c_str(), nullptr, 0);
-        }
-        if (!ssl_cert.empty()) {
-            rd_kafka_conf_set(conf, "ssl.certificate.location", ssl_cert.c_str(), nullptr, 0);
-        }
-        if (!ssl_key.empty()) {
-            rd_kafka_conf_set(conf, "ssl.key.location", ssl_key.c_str(), nullptr, 0);
+    Impl(const ClientConfig& config, const std::vector<std::string>& topics, const AckOptions& ack_options)
+        : acks(ack_options)
+    {
+        char errstr[512];
+
+        // subscribe exige grupo; falhar aqui evita criar o handle à toa
+        if (config.get("group.id").empty())
+            throw std::invalid_argument("Consumer requer group.id");
+
+        conf = rd_kafka_conf_new();
+
+        // brokers, group.id, SSL e ajustes de fetch; valores inválidos viram exceção
+        try {
+            if (acks.enabled) {
+                ClientConfig effective = config;
+                effective.set("enable.auto.commit", "false", ClientConfig::Scope::Consumer);
+                effective.apply(conf, ClientConfig::Scope::Consumer);
+            } else {
+                config.apply(conf, ClientConfig::Scope::Consumer);
+            }
+        } catch (...) {
+            rd_kafka_conf_destroy(conf);
+            throw;
         }
-        // ------------------
+
+        rd_kafka_conf_set_rebalance_cb(conf, rebalance_cb);
+        rd_kafka_conf_set_stats_cb(conf, stats_cb);
+        rd_kafka_conf_set_opaque(conf, this);
 
         // cria consumer
         rk = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
@@ -71,28 +112,74 @@ public:
         // subscribe
         rd_kafka_resp_err_t err = rd_kafka_subscribe(rk, topic_list);
         if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            // o destrutor não roda: libera aqui o que já foi criado
+            rd_kafka_topic_partition_list_destroy(topic_list);
+            rd_kafka_destroy(rk);
             throw std::runtime_error(rd_kafka_err2str(err));
         }
+
+        queue = rd_kafka_queue_get_consumer(rk);
     }
 
     ~Impl() {
+        scratch.clear();
+        // último commit, síncrono, enquanto as partições ainda são nossas
+        if (acks.enabled)
+            tracker.commit(rk, false);
         rd_kafka_unsubscribe(rk);
         rd_kafka_consumer_close(rk);
+        if (event_fd >= 0)
+            rd_kafka_queue_io_event_enable(queue, -1, nullptr, 0);
+        if (ready_callback)
+            rd_kafka_queue_cb_event_enable(queue, nullptr, nullptr);
+        if (queue)
+            rd_kafka_queue_destroy(queue);
+        if (event_fd >= 0)
+            close(event_fd);
         rd_kafka_topic_partition_list_destroy(topic_list);
         rd_kafka_destroy(rk);
     }
 
     void poll(Consumer::MessageCallback callback, int timeout_ms) {
+        poll([&callback](const MessageView& view) {
+            // API antiga: materializa tópico e payload em std::string
+            if (callback)
+                callback(std::string(view.topic()), std::string(view.payload()));
+        }, timeout_ms);
+    }
+
+    // Aplica o filtro à mensagem crua. A descartada conta como processada: no
+    // modo ack é registrada e confirmada na hora; no auto commit a librdkafka já
+    // guardou o offset ao entregá-la.
+    bool accept(const rd_kafka_message_t* msg) {
+        if (!filtering)
+            return true;
+        if (filter.matches(msg)) {
+            filter_passed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        filter_dropped.fetch_add(1, std::memory_order_relaxed);
+        if (acks.enabled) {
+            tracker.complete(tracker.track(msg), msg->offset);
+            unflushed_acks.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    void poll(const Consumer::ViewCallback& callback, int timeout_ms) {
         rd_kafka_message_t* msg = rd_kafka_consumer_poll(rk, timeout_ms);
         if (!msg) return;
 
         if (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
-            // 1. EXTRAIR O NOME DO TÓPICO
-            std::string topic_name(rd_kafka_topic_name(msg->rkt)); // O rkt é o rd_kafka_topic_t*
-
-            // 2. PASSAR O NOME DO TÓPICO E A MENSAGEM PARA O CALLBACK
-            if (callback) {
-                callback(topic_name, std::string((char*)msg->payload, msg->len));
+            // a view aponta direto para a mensagem; 'msg' vira nulo se o callback a reter
+            bool pass = accept(msg);
+            if (pass && acks.enabled)
+                tracker.track(msg);
+            if (pass && callback) {
+                auto polled = std::chrono::steady_clock::now();
+                Receipt receipt = receipt_of(msg);
+                callback(MessageView(msg, &msg));
+                record_latency(polled, &receipt, 1);
             }
         } else if (msg->err != RD_KAFKA_RESP_ERR__PARTITION_EOF &&
                    msg->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
@@ -100,18 +187,287 @@ public:
                       << rd_kafka_message_errstr(msg) << std::endl;
         }
 
-        rd_kafka_message_destroy(msg);
+        if (msg)
+            rd_kafka_message_destroy(msg);
+        maybe_commit(false);
+    }
+
+    int fd() {
+        if (event_fd >= 0)
+            return event_fd;
+
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd < 0)
+            throw std::runtime_error("Erro criando eventfd");
+        // a librdkafka escreve no fd quando a fila passa de vazia para não vazia;
+        // o que já estava na fila é anunciado por nós
+        static const uint64_t one = 1;
+        rd_kafka_queue_io_event_enable(queue, event_fd, &one, sizeof(one));
+        if (write(event_fd, &one, sizeof(one)) < 0) {
+            // contador cheio: o fd já está legível
+        }
+        return event_fd;
+    }
+
+    // Zera o eventfd e esvazia a fila: o fd só volta a ser sinalizado quando a
+    // fila recebe algo de novo. Rebalances e outros callbacks rodam aqui também.
+    void set_ready_callback(std::function<void()> callback) {
+        bool enable = static_cast<bool>(callback);
+        ready_callback = std::move(callback);
+        rd_kafka_queue_cb_event_enable(queue, enable ? ready_cb : nullptr, this);
+    }
+
+    static void ready_cb(rd_kafka_t*, void* opaque) {
+        static_cast<Consumer::Impl*>(opaque)->ready_callback();
+    }
+
+    size_t drain(const Consumer::ViewCallback& callback, size_t max_messages) {
+        if (event_fd >= 0) {
+            uint64_t counter;
+            while (read(event_fd, &counter, sizeof(counter)) == sizeof(counter)) {
+            }
+        }
+
+        size_t delivered = 0;
+        while (delivered < max_messages) {
+            size_t n = poll_batch(scratch, std::min<size_t>(1000, max_messages - delivered), 0);
+            // lote sem nenhuma mensagem (nem erros/EOF): a fila está vazia
+            bool empty = scratch.raw_.empty();
+            if (n > 0 && callback) {
+                auto polled = std::chrono::steady_clock::now();
+                receipts.clear();
+                for (const MessageView& view : scratch)
+                    receipts.push_back(receipt_of(view.raw()));
+                for (const MessageView& view : scratch)
+                    callback(view);
+                record_latency(polled, receipts.data(), receipts.size());
+            }
+            scratch.clear();
+            delivered += n;
+            if (empty)
+                break;
+        }
+        return delivered;
+    }
+
+    void ack(const MessageView& view) {
+        if (!acks.enabled)
+            throw std::runtime_error("ack() requer AckOptions::enabled");
+
+        const rd_kafka_message_t* msg = view.raw();
+        OffsetTracker::Partition* partition = msg ? tracker.get(msg) : nullptr;
+        if (!partition)
+            return; // partição revogada desde a entrega: o novo dono reprocessa
+
+        tracker.complete(partition, msg->offset);
+        if (unflushed_acks.fetch_add(1, std::memory_order_relaxed) + 1 >= acks.commit_every)
+            maybe_commit(true);
+    }
+
+    // Commit assíncrono do que avançou, se 'due' ou se o intervalo já passou.
+    // Só uma thread commita por vez; as outras seguem sem esperar.
+    void maybe_commit(bool due) {
+        if (!acks.enabled)
+            return;
+        std::unique_lock<std::mutex> lock(commit_mutex, std::try_to_lock);
+        if (!lock)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (!due && now - last_commit < std::chrono::milliseconds(acks.commit_interval_ms))
+            return;
+        last_commit = now;
+        unflushed_acks.store(0, std::memory_order_relaxed);
+        tracker.commit(rk, true);
+    }
+
+    void commit() {
+        if (!acks.enabled)
+            return;
+        std::lock_guard<std::mutex> lock(commit_mutex);
+        last_commit = std::chrono::steady_clock::now();
+        unflushed_acks.store(0, std::memory_order_relaxed);
+        tracker.commit(rk, false);
+    }
+
+    // Aplica o rebalanceamento (incremental no cooperative-sticky) e chama os
+    // hooks. Com ack(), commita o confirmado antes de perder as partições; o que
+    // foi entregue e não confirmado é reprocessado pelo próximo dono.
+    static void rebalance_cb(rd_kafka_t* rk, rd_kafka_resp_err_t err,
+                             rd_kafka_topic_partition_list_t* partitions, void* opaque) {
+        auto* self = static_cast<Consumer::Impl*>(opaque);
+
+        if (err == RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS) {
+            assign_partitions(rk, partitions);
+            if (self->hooks.on_assigned)
+                self->hooks.on_assigned(to_vector(partitions));
+            return;
+        }
+
+        bool lost = rd_kafka_assignment_lost(rk);
+        const RebalanceHooks::Callback& hook = lost ? self->hooks.on_lost : self->hooks.on_revoked;
+        if (hook)
+            hook(to_vector(partitions));
+        if (!lost)
+            self->commit();
+        self->tracker.reset(partitions);
+        revoke_partitions(rk, partitions);
+    }
+
+    static std::vector<TopicPartition> to_vector(const rd_kafka_topic_partition_list_t* list) {
+        std::vector<TopicPartition> partitions;
+        if (!list)
+            return partitions;
+        partitions.reserve(static_cast<size_t>(list->cnt));
+        for (int i = 0; i < list->cnt; ++i)
+            partitions.push_back({list->elems[i].topic, list->elems[i].partition});
+        return partitions;
+    }
+
+    void pause_resume(const std::vector<TopicPartition>& partitions, bool pause) {
+        rd_kafka_topic_partition_list_t* list =
+            rd_kafka_topic_partition_list_new(static_cast<int>(partitions.size()));
+        for (const auto& tp : partitions)
+            rd_kafka_topic_partition_list_add(list, tp.topic.c_str(), tp.partition);
+
+        rd_kafka_resp_err_t err = pause ? rd_kafka_pause_partitions(rk, list)
+                                        : rd_kafka_resume_partitions(rk, list);
+        std::string failed;
+        for (int i = 0; err == RD_KAFKA_RESP_ERR_NO_ERROR && i < list->cnt; ++i) {
+            const rd_kafka_topic_partition_t& tp = list->elems[i];
+            if (tp.err != RD_KAFKA_RESP_ERR_NO_ERROR)
+                failed += std::string(failed.empty() ? "" : ", ") + tp.topic + "[" +
+                          std::to_string(tp.partition) + "]: " + rd_kafka_err2str(tp.err);
+        }
+        rd_kafka_topic_partition_list_destroy(list);
+
+        const char* what = pause ? "Erro no pause: " : "Erro no resume: ";
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error(what + std::string(rd_kafka_err2str(err)));
+        if (!failed.empty())
+            throw std::runtime_error(what + failed);
+    }
+
+    void rewind_to_committed(int timeout_ms) {
+        rd_kafka_topic_partition_list_t* list = nullptr;
+        rd_kafka_resp_err_t err = rd_kafka_assignment(rk, &list);
+        if (err == RD_KAFKA_RESP_ERR_NO_ERROR)
+            err = rd_kafka_committed(rk, list, timeout_ms);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            if (list)
+                rd_kafka_topic_partition_list_destroy(list);
+            throw std::runtime_error(std::string("Erro lendo offsets commitados: ") + rd_kafka_err2str(err));
+        }
+
+        // sem commit: a posição inicial volta a ser decidida pelo auto.offset.reset
+        for (int i = 0; i < list->cnt; ++i) {
+            if (list->elems[i].offset < 0)
+                list->elems[i].offset = RD_KAFKA_OFFSET_STORED;
+        }
+        rd_kafka_error_t* error = list->cnt > 0 ? rd_kafka_seek_partitions(rk, list, timeout_ms) : nullptr;
+        rd_kafka_topic_partition_list_destroy(list);
+        if (error) {
+            std::string what = std::string("Erro no seek: ") + rd_kafka_error_string(error);
+            rd_kafka_error_destroy(error);
+            throw std::runtime_error(what);
+        }
+        if (acks.enabled)
+            tracker.reset(nullptr);
+    }
+
+    std::vector<TopicPartition> assignment() const {
+        rd_kafka_topic_partition_list_t* list = nullptr;
+        rd_kafka_resp_err_t err = rd_kafka_assignment(rk, &list);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error(std::string("Erro lendo assignment: ") + rd_kafka_err2str(err));
+        std::vector<TopicPartition> partitions = to_vector(list);
+        rd_kafka_topic_partition_list_destroy(list);
+        return partitions;
+    }
+
+    static int stats_cb(rd_kafka_t*, char* json, size_t json_len, void* opaque) {
+        static_cast<Consumer::Impl*>(opaque)->statistics.store(json, json_len);
+        return 0; // a librdkafka libera o json
+    }
+
+    size_t poll_batch(MessageBatch& batch, size_t max_messages, int timeout_ms) {
+        batch.clear();
+        if (max_messages == 0)
+            return 0;
+
+        batch.raw_.resize(max_messages);
+        ssize_t n = rd_kafka_consume_batch_queue(queue, timeout_ms, batch.raw_.data(), max_messages);
+        if (n < 0) {
+            std::cerr << "Erro ao consumir lote: "
+                      << rd_kafka_err2str(rd_kafka_last_error()) << std::endl;
+            n = 0;
+        }
+        batch.raw_.resize(static_cast<size_t>(n));
+        batch.items_.reserve(batch.raw_.size());
+
+        // raw_ não é mais redimensionado: cada view guarda o endereço do seu slot
+        for (rd_kafka_message_t*& msg : batch.raw_) {
+            if (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+                // filtradas ficam só em raw_, para serem liberadas com o lote
+                if (!accept(msg))
+                    continue;
+                if (acks.enabled)
+                    tracker.track(msg);
+                batch.items_.emplace_back(msg, &msg);
+            } else if (msg->err != RD_KAFKA_RESP_ERR__PARTITION_EOF &&
+                       msg->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+                std::cerr << "Erro ao consumir: "
+                          << rd_kafka_message_errstr(msg) << std::endl;
+            }
+        }
+        maybe_commit(false);
+        return batch.items_.size();
     }
 };
 
+// ---------- MessageBatch ----------
+
+MessageBatch& MessageBatch::operator=(MessageBatch&& other) noexcept {
+    if (this != &other) {
+        clear();
+        items_ = std::move(other.items_);
+        raw_ = std::move(other.raw_);
+    }
+    return *this;
+}
+
+MessageBatch::~MessageBatch() {
+    clear();
+}
+
+void MessageBatch::clear() {
+    for (rd_kafka_message_t* msg : raw_) {
+        if (msg)
+            rd_kafka_message_destroy(msg);
+    }
+    raw_.clear();
+    items_.clear();
+}
+
+// ---------- Consumer ----------
+
 Consumer::Consumer(const std::string& brokers,
                    const std::string& groupId,
                    const std::vector<std::string>& topics,
                    const std::string& ssl_ca,
                    const std::string& ssl_cert,
                    const std::string& ssl_key)
-    : impl_(std::make_unique<Impl>(brokers, groupId, topics,
-                                   ssl_ca, ssl_cert, ssl_key))
+    : impl_(std::make_unique<Impl>(ClientConfig(brokers)
+                                       .group_id(groupId)
+                                       .auto_offset_reset("earliest")
+                                       .ssl(ssl_ca, ssl_cert, ssl_key),
+                                   topics, AckOptions()))
+{
+}
+
+Consumer::Consumer(const ClientConfig& config, const std::vector<std::string>& topics,
+                   const AckOptions& acks)
+    : impl_(std::make_unique<Impl>(config, topics, acks))
 {
 }
 
@@ -121,4 +477,96 @@ void Consumer::poll(MessageCallback callback, int timeout_ms) {
     impl_->poll(callback, timeout_ms);
 }
 
+void Consumer::poll(ViewCallback callback, int timeout_ms) {
+    impl_->poll(callback, timeout_ms);
+}
+
+MessageBatch Consumer::poll_batch(size_t max_messages, int timeout_ms) {
+    MessageBatch batch;
+    impl_->poll_batch(batch, max_messages, timeout_ms);
+    return batch;
+}
+
+int Consumer::fd() {
+    return impl_->fd();
+}
+
+size_t Consumer::drain(ViewCallback callback, size_t max_messages) {
+    return impl_->drain(callback, max_messages);
+}
+
+void Consumer::set_ready_callback(std::function<void()> callback) {
+    impl_->set_ready_callback(std::move(callback));
+}
+
+void Consumer::set_rebalance_hooks(RebalanceHooks hooks) {
+    impl_->hooks = std::move(hooks);
+}
+
+void Consumer::set_filter(MessageFilter filter) {
+    impl_->filtering = !filter.empty();
+    impl_->filter = std::move(filter);
+}
+
+FilterCounters Consumer::filter_counters() const {
+    return {impl_->filter_passed.load(std::memory_order_relaxed),
+            impl_->filter_dropped.load(std::memory_order_relaxed)};
+}
+
+void Consumer::pause(const std::vector<TopicPartition>& partitions) {
+    impl_->pause_resume(partitions, true);
+}
+
+void Consumer::resume(const std::vector<TopicPartition>& partitions) {
+    impl_->pause_resume(partitions, false);
+}
+
+std::vector<TopicPartition> Consumer::assignment() const {
+    return impl_->assignment();
+}
+
+void Consumer::ack(const MessageView& message) {
+    impl_->ack(message);
+}
+
+void Consumer::commit() {
+    impl_->commit();
+}
+
+LatencySnapshot Consumer::processing_latency() const {
+    return impl_->processing.snapshot();
+}
+
+LatencySnapshot Consumer::end_to_end_latency() const {
+    return impl_->end_to_end.snapshot();
+}
+
+void Consumer::rewind_to_committed(int timeout_ms) {
+    impl_->rewind_to_committed(timeout_ms);
+}
+
+rd_kafka_s* Consumer::handle() const {
+    return impl_->rk;
+}
+
+ClientStats Consumer::stats() const {
+    return impl_->statistics.snapshot();
+}
+
+size_t Consumer::poll_batch(BatchCallback callback, size_t max_messages, int timeout_ms) {
+    size_t n = impl_->poll_batch(impl_->scratch, max_messages, timeout_ms);
+    if (n > 0 && callback) {
+        auto polled = std::chrono::steady_clock::now();
+        auto& receipts = impl_->receipts;
+        receipts.clear();
+        for (const MessageView& view : impl_->scratch)
+            receipts.push_back(Impl::receipt_of(view.raw()));
+
+        callback(impl_->scratch);
+        impl_->record_latency(polled, receipts.data(), receipts.size());
+    }
+    impl_->scratch.clear(); // devolve as mensagens à librdkafka, mantendo a capacidade
+    return n;
+}
+
 } // namespace mykafka
@@ -0,0 +1,156 @@
+#include "coro.hpp"
+#include <iostream>
+
+namespace mykafka::coro {
+
+// ---------- SingleThreadExecutor ----------
+
+void SingleThreadExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(handle);
+    }
+    cv_.notify_one();
+}
+
+size_t SingleThreadExecutor::run_pending() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.swap(ready_);
+    }
+    // retomadas podem agendar mais: ficam para a próxima rodada
+    for (auto handle : running_)
+        handle.resume();
+    size_t n = running_.size();
+    running_.clear();
+    return n;
+}
+
+void SingleThreadExecutor::run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopped_ || !ready_.empty(); });
+            if (stopped_) {
+                stopped_ = false; // permite chamar run() de novo
+                return;
+            }
+        }
+        run_pending();
+    }
+}
+
+void SingleThreadExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+}
+
+// ---------- spawn ----------
+
+namespace {
+
+// Corrotina que começa na hora e se destrói sozinha ao terminar
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Detached run_detached(Scheduler& scheduler, Task<void> task) {
+    co_await scheduler.schedule();
+    try {
+        co_await std::move(task);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro numa tarefa: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Erro numa tarefa" << std::endl;
+    }
+}
+
+} // namespace
+
+void spawn(Scheduler& scheduler, Task<void> task) {
+    run_detached(scheduler, std::move(task));
+}
+
+// ---------- SendAwaiter ----------
+
+void SendAwaiter::await_suspend(std::coroutine_handle<> h) {
+    // dois ponteiros: cabe no std::function sem alocar
+    auto callback = [this, h](const DeliveryReport& report) {
+        report_ = report;
+        scheduler_.post(h);
+    };
+
+    // Depois do send a corrotina pode já ter retomado em outra thread (ex.: recusa
+    // imediata): nada deste objeto é usado daqui em diante.
+    if (record_) {
+        // sem cópia e sem dono: o valor vive no quadro da corrotina até ela retomar
+        producer_.send(*record_, Buffer(const_cast<char*>(value_.data()), value_.size(), nullptr), callback);
+    } else {
+        producer_.send(topic_, value_, callback);
+    }
+}
+
+// ---------- AsyncConsumer ----------
+
+AsyncConsumer::AsyncConsumer(Consumer& consumer, Scheduler& scheduler)
+    : consumer_(consumer), scheduler_(scheduler)
+{
+    consumer_.set_ready_callback([this]() { on_ready(); });
+}
+
+AsyncConsumer::~AsyncConsumer() {
+    consumer_.set_ready_callback(nullptr);
+}
+
+void AsyncConsumer::on_ready() {
+    ready_.store(true);
+    if (void* waiter = waiter_.exchange(nullptr))
+        scheduler_.post(std::coroutine_handle<>::from_address(waiter));
+}
+
+bool AsyncConsumer::ReadyAwaiter::await_suspend(std::coroutine_handle<> h) {
+    self.waiter_.store(h.address());
+    // algo chegou entre o drain e aqui: se ainda formos donos do handle, não suspende
+    if (self.ready_.load()) {
+        void* expected = h.address();
+        if (self.waiter_.compare_exchange_strong(expected, nullptr))
+            return false;
+        // o on_ready já pegou o handle e vai agendá-lo
+    }
+    return true;
+}
+
+Task<Message> AsyncConsumer::next() {
+    for (;;) {
+        // o sinal só vem quando a fila passa de vazia para não vazia:
+        // antes de esperar, o drain precisa ver a fila vazia
+        ready_.store(false);
+        Message message;
+        if (consumer_.drain([&message](const MessageView& view) { message = view.retain(); }, 1) > 0)
+            co_return message;
+        co_await ReadyAwaiter{*this};
+    }
+}
+
+Task<std::vector<Message>> AsyncConsumer::next_batch(size_t max_messages) {
+    std::vector<Message> messages;
+    for (;;) {
+        ready_.store(false);
+        consumer_.drain([&messages](const MessageView& view) { messages.push_back(view.retain()); },
+                        max_messages);
+        if (!messages.empty())
+            co_return messages;
+        co_await ReadyAwaiter{*this};
+    }
+}
+
+} // namespace mykafka::coro
@@ -0,0 +1,65 @@
+#include "crc32c.hpp"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define MYKAFKA_X86_64 1
+#endif
+
+namespace mykafka {
+
+namespace {
+
+uint32_t crc32c_table(uint32_t crc, const char* data, size_t size) {
+    static const auto table = []() {
+        struct { uint32_t t[256]; } t;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+            t.t[i] = c;
+        }
+        return t;
+    }();
+
+    for (size_t i = 0; i < size; ++i)
+        crc = table.t[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef MYKAFKA_X86_64
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const char* data, size_t size) {
+    uint64_t c = crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    for (; size > 0; ++data, --size)
+        c32 = _mm_crc32_u8(c32, static_cast<uint8_t>(*data));
+    return c32;
+}
+#endif
+
+using CrcFn = uint32_t (*)(uint32_t crc, const char* data, size_t size);
+
+CrcFn select() {
+#ifdef MYKAFKA_X86_64
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return crc32c_sse42;
+#endif
+    return crc32c_table;
+}
+
+const CrcFn crc_fn = select();
+
+} // namespace
+
+uint32_t crc32c(const char* data, size_t size) {
+    return crc_fn(0xFFFFFFFFu, data, size) ^ 0xFFFFFFFFu;
+}
+
+} // namespace mykafka
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mykafka {
+
+// CRC32C (Castagnoli). Usa a instrução crc32 do SSE4.2 quando a CPU tem,
+// senão uma tabela; a escolha é feita uma vez, na carga.
+uint32_t crc32c(const char* data, size_t size);
+
+} // namespace mykafka
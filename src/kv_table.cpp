@@ -0,0 +1,253 @@
+#include "kv_table.hpp"
+#include <cstring>
+
+namespace mykafka {
+
+namespace {
+
+constexpr size_t kArenaStart = 8;
+constexpr uint64_t kMagic = 0x3142544B564B4D; // "MKVKTB1": muda se o hash ou o layout mudarem
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 16;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+struct Header {
+    uint64_t magic;
+    uint64_t slots;
+    uint64_t size;
+    uint64_t arena;
+    uint64_t dead;
+};
+
+} // namespace
+
+uint64_t KvTable::hash(std::string_view key) {
+    // 8 bytes por vez, com finalização do murmur3
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (key.size() * 0xc6a4a7935bd1e995ULL);
+    const char* p = key.data();
+    size_t n = key.size();
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ mix(word)) * 0x9E3779B97F4A7C15ULL;
+    }
+    if (n > 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, n);
+        h = (h ^ mix(word)) * 0x9E3779B97F4A7C15ULL;
+    }
+    return mix(h);
+}
+
+KvTable::KvTable(size_t initial_slots)
+    : slots_(round_up_pow2(initial_slots), Slot{0, 0}), arena_(kArenaStart)
+{
+}
+
+KvTable::Record KvTable::record(uint64_t ref) const {
+    Record r;
+    std::memcpy(&r, arena_.data() + ref, sizeof(r));
+    return r;
+}
+
+size_t KvTable::find(std::string_view key, uint64_t h) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const Slot& s = slots_[i];
+        if (s.ref == 0)
+            return SIZE_MAX;
+        if (s.hash != h)
+            continue;
+        Record r = record(s.ref);
+        if (r.key_len == key.size() &&
+            std::memcmp(arena_.data() + s.ref + sizeof(Record), key.data(), key.size()) == 0)
+            return i;
+    }
+}
+
+uint64_t KvTable::append(std::string_view key, std::string_view value) {
+    Record r{static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size()),
+             static_cast<uint32_t>(value.size()), 0};
+    uint64_t ref = arena_.size();
+    arena_.resize(ref + sizeof(Record) + key.size() + value.size());
+    char* p = arena_.data() + ref;
+    std::memcpy(p, &r, sizeof(r));
+    if (!key.empty())
+        std::memcpy(p + sizeof(r), key.data(), key.size());
+    if (!value.empty())
+        std::memcpy(p + sizeof(r) + key.size(), value.data(), value.size());
+    return ref;
+}
+
+void KvTable::put(std::string_view key, std::string_view value) {
+    uint64_t h = hash(key);
+    size_t i = find(key, h);
+    if (i != SIZE_MAX) {
+        Slot& s = slots_[i];
+        Record r = record(s.ref);
+        if (value.size() <= r.value_cap) {
+            // cabe no lugar: atualização sem alocar
+            r.value_len = static_cast<uint32_t>(value.size());
+            char* p = arena_.data() + s.ref;
+            std::memcpy(p, &r, sizeof(r));
+            if (!value.empty())
+                std::memcpy(p + sizeof(r) + r.key_len, value.data(), value.size());
+            return;
+        }
+        dead_bytes_ += sizeof(Record) + r.key_len + r.value_cap;
+        s.ref = append(key, value);
+        maybe_compact();
+        return;
+    }
+
+    // carga máxima de 70%
+    if ((size_ + 1) * 10 > slots_.size() * 7)
+        grow();
+    size_t mask = slots_.size() - 1;
+    i = h & mask;
+    while (slots_[i].ref != 0)
+        i = (i + 1) & mask;
+    slots_[i] = Slot{h, append(key, value)};
+    ++size_;
+}
+
+bool KvTable::erase(std::string_view key) {
+    size_t i = find(key, hash(key));
+    if (i == SIZE_MAX)
+        return false;
+
+    Record r = record(slots_[i].ref);
+    dead_bytes_ += sizeof(Record) + r.key_len + r.value_cap;
+    --size_;
+
+    // desloca para trás os slots seguintes que não estão na posição ideal
+    size_t mask = slots_.size() - 1;
+    for (size_t j = (i + 1) & mask; slots_[j].ref != 0; j = (j + 1) & mask) {
+        size_t home = slots_[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+    slots_[i] = Slot{0, 0};
+    maybe_compact();
+    return true;
+}
+
+bool KvTable::get(std::string_view key, std::string& value) const {
+    size_t i = find(key, hash(key));
+    if (i == SIZE_MAX)
+        return false;
+    uint64_t ref = slots_[i].ref;
+    Record r = record(ref);
+    value.assign(arena_.data() + ref + sizeof(Record) + r.key_len, r.value_len);
+    return true;
+}
+
+bool KvTable::contains(std::string_view key) const {
+    return find(key, hash(key)) != SIZE_MAX;
+}
+
+size_t KvTable::memory_bytes() const {
+    return slots_.capacity() * sizeof(Slot) + arena_.capacity();
+}
+
+void KvTable::grow() {
+    std::vector<Slot> old(slots_.size() * 2, Slot{0, 0});
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot& s : old) {
+        if (s.ref == 0)
+            continue;
+        size_t i = s.hash & mask;
+        while (slots_[i].ref != 0)
+            i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
+// Reescreve a arena só com os registros vivos quando o lixo passa da metade
+void KvTable::maybe_compact() {
+    if (dead_bytes_ < (1 << 20) || dead_bytes_ * 2 < arena_.size())
+        return;
+
+    std::vector<char> live;
+    live.reserve(arena_.size() - dead_bytes_);
+    live.resize(kArenaStart);
+    for (Slot& s : slots_) {
+        if (s.ref == 0)
+            continue;
+        Record r = record(s.ref);
+        size_t bytes = sizeof(Record) + r.key_len + r.value_len;
+        uint64_t ref = live.size();
+        live.resize(ref + bytes);
+        r.value_cap = r.value_len;
+        std::memcpy(live.data() + ref, &r, sizeof(r));
+        std::memcpy(live.data() + ref + sizeof(r), arena_.data() + s.ref + sizeof(r), r.key_len);
+        std::memcpy(live.data() + ref + sizeof(r) + r.key_len,
+                    arena_.data() + s.ref + sizeof(r) + r.key_len, r.value_len);
+        s.ref = ref;
+    }
+    arena_.swap(live);
+    dead_bytes_ = 0;
+}
+
+size_t KvTable::serialized_size() const {
+    return sizeof(Header) + slots_.size() * sizeof(Slot) + arena_.size();
+}
+
+void KvTable::serialize(char* out) const {
+    Header h{kMagic, slots_.size(), size_, arena_.size(), dead_bytes_};
+    std::memcpy(out, &h, sizeof(h));
+    out += sizeof(h);
+    std::memcpy(out, slots_.data(), slots_.size() * sizeof(Slot));
+    out += slots_.size() * sizeof(Slot);
+    std::memcpy(out, arena_.data(), arena_.size());
+}
+
+bool KvTable::deserialize(const char* data, size_t size) {
+    Header h;
+    bool ok = size >= sizeof(Header);
+    if (ok) {
+        std::memcpy(&h, data, sizeof(h));
+        ok = h.magic == kMagic && h.slots >= 16 && (h.slots & (h.slots - 1)) == 0 &&
+             h.arena >= kArenaStart && h.size < h.slots &&
+             size == sizeof(Header) + h.slots * sizeof(Slot) + h.arena;
+    }
+    if (!ok) {
+        *this = KvTable();
+        return false;
+    }
+
+    data += sizeof(Header);
+    slots_.resize(h.slots);
+    std::memcpy(slots_.data(), data, h.slots * sizeof(Slot));
+    arena_.assign(data + h.slots * sizeof(Slot), data + h.slots * sizeof(Slot) + h.arena);
+    size_ = h.size;
+    dead_bytes_ = h.dead;
+
+    // referências fora da arena: dados inconsistentes
+    for (const Slot& s : slots_) {
+        if (s.ref != 0 && (s.ref < kArenaStart || s.ref + sizeof(Record) > arena_.size() ||
+                           s.ref + sizeof(Record) + record(s.ref).key_len + record(s.ref).value_cap > arena_.size())) {
+            *this = KvTable();
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace mykafka
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mykafka {
+
+// Tabela hash de endereçamento aberto (sondagem linear) com chaves e valores
+// numa arena contígua. Cada slot tem 16 bytes: o hash completo, que filtra as
+// colisões sem tocar na arena, e a posição do registro. Remoção por
+// deslocamento para trás, sem marcadores de apagado. Valores que crescem vão
+// para o fim da arena; o espaço antigo é recuperado pela compactação.
+//
+// Não é thread-safe: o TableConsumer protege com um shared_mutex.
+class KvTable {
+public:
+    explicit KvTable(size_t initial_slots = 1 << 16);
+
+    void put(std::string_view key, std::string_view value);
+    bool erase(std::string_view key);
+    // copia o valor para 'value'; false se a chave não existir
+    bool get(std::string_view key, std::string& value) const;
+    bool contains(std::string_view key) const;
+
+    size_t size() const { return size_; }
+    size_t memory_bytes() const; // slots + arena reservados
+
+    // Formato binário para snapshot (ordem de bytes da máquina)
+    size_t serialized_size() const;
+    void serialize(char* out) const;
+    // false se os dados não formam uma tabela válida; a tabela fica vazia
+    bool deserialize(const char* data, size_t size);
+
+    // hash usado nos slots; fixo, porque vai para o snapshot
+    static uint64_t hash(std::string_view key);
+
+private:
+    struct Slot {
+        uint64_t hash;
+        uint64_t ref; // posição do registro na arena; 0 = vazio
+    };
+    struct Record {
+        uint32_t key_len;
+        uint32_t value_len;
+        uint32_t value_cap; // espaço reservado para o valor
+        uint32_t reserved;
+    };
+
+    size_t find(std::string_view key, uint64_t h) const; // índice do slot ou SIZE_MAX
+    Record record(uint64_t ref) const;
+    uint64_t append(std::string_view key, std::string_view value);
+    void grow();
+    void maybe_compact();
+
+    std::vector<Slot> slots_; // potência de 2
+    std::vector<char> arena_; // começa com 8 bytes reservados: ref 0 = vazio
+    size_t size_ = 0;
+    size_t dead_bytes_ = 0;   // registros substituídos ou apagados
+};
+
+} // namespace mykafka
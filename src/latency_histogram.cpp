@@ -0,0 +1,51 @@
+#include "latency_histogram.hpp"
+
+namespace mykafka {
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    uint64_t counts[kBuckets];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    LatencySnapshot snap;
+    snap.count = total;
+    if (total == 0)
+        return snap;
+    snap.mean_us = static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / total;
+
+    // posição (1-based) de cada percentil no conjunto ordenado
+    auto rank = [total](double q) {
+        uint64_t r = static_cast<uint64_t>(q * total + 0.5);
+        return r == 0 ? 1 : r;
+    };
+    const uint64_t r50 = rank(0.50), r90 = rank(0.90), r99 = rank(0.99), r999 = rank(0.999);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        if (counts[i] == 0)
+            continue;
+        // o percentil é deste bucket se a posição cai dentro dele; 0 é um
+        // valor válido (bucket de 0 µs), não serve de marcador
+        const uint64_t before = seen;
+        seen += counts[i];
+        const uint64_t value = upper_bound_of(i);
+        auto here = [before, seen](uint64_t r) { return before < r && r <= seen; };
+        if (here(r50))  snap.p50_us = value;
+        if (here(r90))  snap.p90_us = value;
+        if (here(r99))  snap.p99_us = value;
+        if (here(r999)) snap.p999_us = value;
+        snap.max_us = value;
+    }
+    return snap;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets_)
+        b.store(0, std::memory_order_relaxed);
+    sum_us_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace mykafka
@@ -0,0 +1,73 @@
+#include "message_filter.hpp"
+#include "pattern_search.hpp"
+#include <librdkafka/rdkafka.h>
+#include <cstring>
+#include <string_view>
+
+namespace mykafka {
+
+MessageFilter& MessageFilter::header_equals(std::string name, std::string value) {
+    headers_.push_back({std::move(name), std::move(value)});
+    return *this;
+}
+
+MessageFilter& MessageFilter::key_prefix(std::string prefix) {
+    key_prefixes_.push_back(std::move(prefix));
+    return *this;
+}
+
+MessageFilter& MessageFilter::payload_contains(std::string pattern) {
+    payload_.push_back({std::move(pattern)});
+    return *this;
+}
+
+MessageFilter& MessageFilter::payload_contains_any(std::vector<std::string> patterns) {
+    payload_.push_back(std::move(patterns));
+    return *this;
+}
+
+bool MessageFilter::empty() const {
+    return key_prefixes_.empty() && headers_.empty() && payload_.empty();
+}
+
+bool MessageFilter::matches(const rd_kafka_message_t* msg) const {
+    for (const std::string& prefix : key_prefixes_) {
+        if (!msg->key || msg->key_len < prefix.size() ||
+            std::memcmp(msg->key, prefix.data(), prefix.size()) != 0)
+            return false;
+    }
+
+    if (!headers_.empty()) {
+        // a librdkafka decodifica os cabeçalhos na primeira chamada
+        rd_kafka_headers_t* hdrs = nullptr;
+        if (rd_kafka_message_headers(msg, &hdrs) != RD_KAFKA_RESP_ERR_NO_ERROR)
+            return false;
+        for (const HeaderEquals& h : headers_) {
+            const void* value = nullptr;
+            size_t size = 0;
+            if (rd_kafka_header_get_last(hdrs, h.name.c_str(), &value, &size) != RD_KAFKA_RESP_ERR_NO_ERROR ||
+                !value || size != h.value.size() || std::memcmp(value, h.value.data(), size) != 0)
+                return false;
+        }
+    }
+
+    std::string_view payload(static_cast<const char*>(msg->payload), msg->payload ? msg->len : 0);
+    for (const std::vector<std::string>& any : payload_) {
+        bool found = false;
+        for (const std::string& pattern : any) {
+            if (contains(payload, pattern)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+const char* MessageFilter::simd_level() {
+    return pattern_search_isa();
+}
+
+} // namespace mykafka
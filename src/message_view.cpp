@@ -0,0 +1,96 @@
+#include "message_view.hpp"
+#include <librdkafka/rdkafka.h>
+
+namespace mykafka {
+
+// ---------- Headers ----------
+
+Header MessageView::Headers::iterator::operator*() const {
+    const char* name = nullptr;
+    const void* value = nullptr;
+    size_t size = 0;
+    rd_kafka_header_get_all(hdrs_, idx_, &name, &value, &size);
+    return {name ? std::string_view(name) : std::string_view(),
+            std::string_view(static_cast<const char*>(value), size)};
+}
+
+size_t MessageView::Headers::size() const {
+    return hdrs_ ? rd_kafka_header_cnt(hdrs_) : 0;
+}
+
+bool MessageView::Headers::find(std::string_view name, std::string_view& value) const {
+    // percorre de trás para frente para devolver o último valor, como o get_last
+    for (size_t i = size(); i-- > 0;) {
+        Header h = *iterator(hdrs_, i);
+        if (h.name == name) {
+            value = h.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------- MessageView ----------
+
+std::string_view MessageView::topic() const {
+    return rd_kafka_topic_name(msg_->rkt);
+}
+
+std::string_view MessageView::key() const {
+    return std::string_view(static_cast<const char*>(msg_->key), msg_->key_len);
+}
+
+std::string_view MessageView::payload() const {
+    return std::string_view(static_cast<const char*>(msg_->payload), msg_->len);
+}
+
+bool MessageView::has_key() const {
+    return msg_->key != nullptr;
+}
+
+int32_t MessageView::partition() const {
+    return msg_->partition;
+}
+
+int64_t MessageView::offset() const {
+    return msg_->offset;
+}
+
+int64_t MessageView::timestamp() const {
+    rd_kafka_timestamp_type_t type;
+    return rd_kafka_message_timestamp(msg_, &type);
+}
+
+MessageView::Headers MessageView::headers() const {
+    rd_kafka_headers_t* hdrs = nullptr;
+    if (rd_kafka_message_headers(msg_, &hdrs) != RD_KAFKA_RESP_ERR_NO_ERROR)
+        hdrs = nullptr; // mensagem sem cabeçalhos
+    return Headers(hdrs);
+}
+
+Message MessageView::retain() const {
+    if (!owner_ || !*owner_)
+        return Message();
+    rd_kafka_message_t* msg = *owner_;
+    *owner_ = nullptr; // o Consumer não libera mais esta mensagem
+    return Message(msg);
+}
+
+// ---------- Message ----------
+
+Message& Message::operator=(Message&& other) noexcept {
+    if (this != &other) {
+        if (msg_)
+            rd_kafka_message_destroy(msg_);
+        msg_ = other.msg_;
+        other.msg_ = nullptr;
+    }
+    return *this;
+}
+
+Message::~Message() {
+    if (msg_)
+        rd_kafka_message_destroy(msg_);
+}
+
+} // namespace mykafka
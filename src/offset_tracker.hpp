@@ -0,0 +1,151 @@
+#pragma once
+
+#include <librdkafka/rdkafka.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace mykafka {
+
+// Acompanha, por partição, os offsets entregues ao código do usuário e os já
+// processados. O ponto de commit é o maior offset contíguo processado + 1,
+// mesmo que as mensagens terminem fora de ordem: um buraco segura o commit
+// até ser preenchido (at-least-once).
+class OffsetTracker {
+public:
+    struct Partition {
+        std::string topic;
+        int32_t id = 0;
+        size_t index = 0; // ordem de criação; o ParallelConsumer usa para escolher o worker
+
+        std::mutex mutex;
+        std::deque<std::pair<int64_t, bool>> pending; // {offset, processado}, em ordem de entrega
+        int64_t next = -1;      // próximo offset a commitar
+        int64_t committed = -1; // último 'next' já enviado para commit
+    };
+
+    // Registra a mensagem como entregue e devolve a partição dela.
+    // Mensagens de uma mesma partição precisam ser registradas em ordem.
+    Partition* track(const rd_kafka_message_t* msg) {
+        Partition* p = find(msg->rkt, msg->partition, true);
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->pending.emplace_back(msg->offset, false);
+        return p;
+    }
+
+    // Partição de uma mensagem já registrada; nullptr se não houver
+    Partition* get(const rd_kafka_message_t* msg) {
+        return find(msg->rkt, msg->partition, false);
+    }
+
+    // Marca o offset como processado e avança o ponto de commit, se possível.
+    // Retorna false se o offset não estava pendente (repetido ou de antes de um reset).
+    bool complete(Partition* p, int64_t offset) {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        auto& pending = p->pending;
+        // quase sempre é o primeiro: processamento em ordem
+        auto it = pending.begin();
+        if (it == pending.end() || it->first != offset) {
+            it = std::lower_bound(pending.begin(), pending.end(), offset,
+                                  [](const std::pair<int64_t, bool>& e, int64_t o) { return e.first < o; });
+            if (it == pending.end() || it->first != offset || it->second)
+                return false;
+        }
+        it->second = true;
+
+        while (!pending.empty() && pending.front().second) {
+            p->next = pending.front().first + 1;
+            pending.pop_front();
+        }
+        return true;
+    }
+
+    // Lista com os pontos de commit que avançaram desde a última chamada
+    // ('all' inclui também os que não mudaram). nullptr se não houver nada.
+    // Quem chama faz o commit e destrói a lista.
+    rd_kafka_topic_partition_list_t* take_commits(bool all = false) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rd_kafka_topic_partition_list_t* list = nullptr;
+        for (auto& kv : partitions_) {
+            Partition& p = *kv.second;
+            std::lock_guard<std::mutex> plock(p.mutex);
+            if (p.next < 0 || (!all && p.next == p.committed))
+                continue;
+            if (!list)
+                list = rd_kafka_topic_partition_list_new(static_cast<int>(partitions_.size()));
+            rd_kafka_topic_partition_list_add(list, p.topic.c_str(), p.id)->offset = p.next;
+            p.committed = p.next;
+        }
+        return list;
+    }
+
+    // Commita o que avançou (async) ou todos os pontos conhecidos (síncrono,
+    // antes de revogar ou fechar). Erros do síncrono vão para o stderr.
+    void commit(rd_kafka_t* rk, bool async) {
+        rd_kafka_topic_partition_list_t* offsets = take_commits(!async);
+        if (!offsets)
+            return;
+        rd_kafka_resp_err_t err = rd_kafka_commit(rk, offsets, async ? 1 : 0);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR && err != RD_KAFKA_RESP_ERR__NO_OFFSET)
+            std::cerr << "Erro no commit: " << rd_kafka_err2str(err) << std::endl;
+        rd_kafka_topic_partition_list_destroy(offsets);
+    }
+
+    // Esquece o estado das partições revogadas (o commit delas deve ser feito antes).
+    // Os objetos continuam vivos: ponteiros guardados por workers não ficam pendurados.
+    void reset(const rd_kafka_topic_partition_list_t* partitions) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& kv : partitions_) {
+            Partition& p = *kv.second;
+            if (partitions && !rd_kafka_topic_partition_list_find(partitions, p.topic.c_str(), p.id))
+                continue;
+            std::lock_guard<std::mutex> plock(p.mutex);
+            p.pending.clear();
+            p.next = -1;
+            p.committed = -1;
+        }
+    }
+
+    // mensagens entregues e ainda não processadas, somando todas as partições
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto& kv : partitions_) {
+            std::lock_guard<std::mutex> plock(kv.second->mutex);
+            total += kv.second->pending.size();
+        }
+        return total;
+    }
+
+private:
+    // o handle do tópico é estável enquanto o consumer existir: evita comparar nomes
+    using Key = std::pair<const rd_kafka_topic_t*, int32_t>;
+
+    Partition* find(const rd_kafka_topic_t* rkt, int32_t partition, bool create) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = partitions_.find(Key(rkt, partition));
+        if (it != partitions_.end())
+            return it->second.get();
+        if (!create)
+            return nullptr;
+
+        auto p = std::make_unique<Partition>();
+        p->topic = rd_kafka_topic_name(rkt);
+        p->id = partition;
+        p->index = partitions_.size();
+        Partition* raw = p.get();
+        partitions_.emplace(Key(rkt, partition), std::move(p));
+        return raw;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<Key, std::unique_ptr<Partition>> partitions_;
+};
+
+} // namespace mykafka
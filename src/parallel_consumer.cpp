@@ -0,0 +1,298 @@
+#include "parallel_consumer.hpp"
+#include "offset_tracker.hpp"
+#include "spsc_queue.hpp"
+#include "rebalance.hpp"
+#include <librdkafka/rdkafka.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace mykafka {
+
+namespace {
+
+struct WorkItem {
+    rd_kafka_message_t* msg = nullptr;
+    OffsetTracker::Partition* partition = nullptr;
+};
+
+struct Worker {
+    explicit Worker(size_t capacity) : queue(capacity) {}
+
+    SpscQueue<WorkItem> queue;
+
+    // usados só quando a fila fica vazia por um tempo
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> sleeping{false};
+
+    std::thread thread;
+
+    void wake() {
+        if (sleeping.load()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cv.notify_one();
+        }
+    }
+};
+
+} // namespace
+
+class ParallelConsumer::Impl {
+public:
+    rd_kafka_t* rk = nullptr;
+    rd_kafka_topic_partition_list_t* topic_list = nullptr;
+    rd_kafka_queue_t* queue = nullptr;
+
+    Handler handler;
+    WorkerOptions options;
+    OffsetTracker tracker;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{true};
+
+    std::atomic<uint64_t> processed{0};
+    std::atomic<size_t> in_flight{0};
+
+    std::vector<rd_kafka_message_t*> raw; // reaproveitado entre polls
+    std::chrono::steady_clock::time_point last_commit = std::chrono::steady_clock::now();
+
+    Impl(const ClientConfig& config, const std::vector<std::string>& topics,
+         Handler h, const WorkerOptions& opts)
+        : handler(std::move(h)), options(opts)
+    {
+        char errstr[512];
+
+        if (options.workers == 0)
+            options.workers = std::max(1u, std::thread::hardware_concurrency());
+        if (options.max_batch == 0)
+            options.max_batch = 1;
+
+        // o commit é nosso: só depois do processamento
+        ClientConfig effective = config;
+        effective.set("enable.auto.commit", "false", ClientConfig::Scope::Consumer);
+
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        try {
+            effective.apply(conf, ClientConfig::Scope::Consumer);
+        } catch (...) {
+            rd_kafka_conf_destroy(conf);
+            throw;
+        }
+
+        rd_kafka_conf_set_rebalance_cb(conf, rebalance_cb);
+        rd_kafka_conf_set_opaque(conf, this);
+
+        rk = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
+        if (!rk)
+            throw std::runtime_error(std::string("Erro criando consumer: ") + errstr);
+
+        rd_kafka_poll_set_consumer(rk);
+
+        topic_list = rd_kafka_topic_partition_list_new(static_cast<int>(topics.size()));
+        for (const auto& t : topics)
+            rd_kafka_topic_partition_list_add(topic_list, t.c_str(), RD_KAFKA_PARTITION_UA);
+
+        rd_kafka_resp_err_t err = rd_kafka_subscribe(rk, topic_list);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            rd_kafka_topic_partition_list_destroy(topic_list);
+            rd_kafka_destroy(rk);
+            throw std::runtime_error(rd_kafka_err2str(err));
+        }
+
+        queue = rd_kafka_queue_get_consumer(rk);
+
+        for (size_t i = 0; i < options.workers; ++i)
+            workers.push_back(std::make_unique<Worker>(options.queue_capacity));
+        for (auto& w : workers) {
+            Worker* worker = w.get();
+            worker->thread = std::thread([this, worker]() { worker_loop(*worker); });
+        }
+    }
+
+    ~Impl() {
+        commit_sync();
+        // o close ainda dispara o rebalance de revogação (que commita de novo, sem nada pendente)
+        rd_kafka_consumer_close(rk);
+
+        running.store(false);
+        for (auto& w : workers) {
+            {
+                std::lock_guard<std::mutex> lock(w->mutex);
+                w->cv.notify_one();
+            }
+            w->thread.join();
+        }
+
+        rd_kafka_queue_destroy(queue);
+        rd_kafka_topic_partition_list_destroy(topic_list);
+        rd_kafka_destroy(rk);
+    }
+
+    size_t poll(int timeout_ms) {
+        raw.resize(options.max_batch);
+        ssize_t n = rd_kafka_consume_batch_queue(queue, timeout_ms, raw.data(), raw.size());
+        if (n < 0) {
+            std::cerr << "Erro ao consumir lote: "
+                      << rd_kafka_err2str(rd_kafka_last_error()) << std::endl;
+            n = 0;
+        }
+
+        size_t dispatched = 0;
+        for (ssize_t i = 0; i < n; ++i) {
+            rd_kafka_message_t* msg = raw[i];
+            if (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+                dispatch(msg);
+                ++dispatched;
+                continue;
+            }
+            if (msg->err != RD_KAFKA_RESP_ERR__PARTITION_EOF &&
+                msg->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+                std::cerr << "Erro ao consumir: "
+                          << rd_kafka_message_errstr(msg) << std::endl;
+            }
+            rd_kafka_message_destroy(msg);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_commit >= std::chrono::milliseconds(options.commit_interval_ms)) {
+            tracker.commit(rk, true);
+            last_commit = now;
+        }
+        return dispatched;
+    }
+
+    void dispatch(rd_kafka_message_t* msg) {
+        OffsetTracker::Partition* partition = tracker.track(msg);
+
+        size_t index = partition->index;
+        if (options.dispatch == WorkerOptions::Dispatch::Key && msg->key) {
+            index = std::hash<std::string_view>()(
+                std::string_view(static_cast<const char*>(msg->key), msg->key_len));
+        }
+        Worker& worker = *workers[index % workers.size()];
+
+        in_flight.fetch_add(1, std::memory_order_relaxed);
+        // fila cheia: o poll espera o worker, e a librdkafka segura o resto na pré-busca
+        while (!worker.queue.try_push(WorkItem{msg, partition})) {
+            worker.wake();
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        worker.wake();
+    }
+
+    void worker_loop(Worker& worker) {
+        WorkItem item;
+        int idle = 0;
+        for (;;) {
+            if (worker.queue.try_pop(item)) {
+                process(item);
+                idle = 0;
+                continue;
+            }
+            if (!running.load()) {
+                if (worker.queue.empty())
+                    break;
+                continue;
+            }
+            // um pouco de espera ativa antes de dormir: mensagens chegam em rajadas
+            if (++idle < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.sleeping.store(true);
+            if (worker.queue.empty() && running.load())
+                worker.cv.wait_for(lock, std::chrono::milliseconds(1));
+            worker.sleeping.store(false);
+            idle = 0;
+        }
+    }
+
+    void process(WorkItem& item) {
+        // o handler pode reter e liberar a mensagem: o offset é lido antes
+        int64_t offset = item.msg->offset;
+        try {
+            handler(MessageView(item.msg, &item.msg));
+        } catch (const std::exception& e) {
+            std::cerr << "Erro no handler (offset " << offset << "): " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Erro no handler (offset " << offset << ")" << std::endl;
+        }
+        if (item.msg)
+            rd_kafka_message_destroy(item.msg);
+
+        tracker.complete(item.partition, offset);
+        processed.fetch_add(1, std::memory_order_relaxed);
+        in_flight.fetch_sub(1, std::memory_order_release);
+    }
+
+    // espera os workers terminarem tudo que já foi despachado
+    void quiesce() {
+        while (in_flight.load(std::memory_order_acquire) > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    void commit_sync() {
+        quiesce();
+        tracker.commit(rk, false);
+    }
+
+    // Roda na thread do poll. Antes de perder partições, termina o que foi
+    // despachado e commita, para o próximo dono não reprocessar.
+    static void rebalance_cb(rd_kafka_t* rk, rd_kafka_resp_err_t err,
+                             rd_kafka_topic_partition_list_t* partitions, void* opaque) {
+        auto* self = static_cast<Impl*>(opaque);
+
+        if (err == RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS) {
+            assign_partitions(rk, partitions);
+            return;
+        }
+
+        // revogadas ou perdidas: se perdidas, outro membro já é dono e o commit falharia
+        if (rd_kafka_assignment_lost(rk))
+            self->quiesce();
+        else
+            self->commit_sync();
+        self->tracker.reset(partitions);
+        revoke_partitions(rk, partitions);
+    }
+};
+
+ParallelConsumer::ParallelConsumer(const ClientConfig& config,
+                                   const std::vector<std::string>& topics,
+                                   Handler handler,
+                                   const WorkerOptions& options)
+    : impl_(std::make_unique<Impl>(config, topics, std::move(handler), options))
+{
+}
+
+ParallelConsumer::~ParallelConsumer() = default;
+
+size_t ParallelConsumer::poll(int timeout_ms) {
+    return impl_->poll(timeout_ms);
+}
+
+void ParallelConsumer::commit() {
+    impl_->commit_sync();
+}
+
+size_t ParallelConsumer::workers() const {
+    return impl_->workers.size();
+}
+
+uint64_t ParallelConsumer::processed() const {
+    return impl_->processed.load(std::memory_order_relaxed);
+}
+
+size_t ParallelConsumer::in_flight() const {
+    return impl_->in_flight.load(std::memory_order_relaxed);
+}
+
+} // namespace mykafka
@@ -0,0 +1,109 @@
+#include "pattern_search.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MYKAFKA_X86 1
+#endif
+
+namespace mykafka {
+
+namespace {
+
+using FindFn = bool (*)(const char* s, size_t n, const char* p, size_t k);
+
+// k >= 2 em todas as versões; 0 e 1 são tratados antes
+bool find_scalar(const char* s, size_t n, const char* p, size_t k) {
+    return memmem(s, n, p, k) != nullptr;
+}
+
+#ifdef MYKAFKA_X86
+
+// Posições i cujo byte i é p[0] e o byte i+k-1 é p[k-1]; só elas vão para o memcmp
+bool find_sse2(const char* s, size_t n, const char* p, size_t k) {
+    if (n < k)
+        return false;
+    const __m128i first = _mm_set1_epi8(p[0]);
+    const __m128i last = _mm_set1_epi8(p[k - 1]);
+
+    size_t i = 0;
+    for (; i + k - 1 + 16 <= n; i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + k - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(s + i + bit + 1, p + 1, k - 2) == 0)
+                return true;
+            mask &= mask - 1;
+        }
+    }
+    return find_scalar(s + i, n - i, p, k);
+}
+
+__attribute__((target("avx2")))
+bool find_avx2(const char* s, size_t n, const char* p, size_t k) {
+    if (n < k)
+        return false;
+    const __m256i first = _mm256_set1_epi8(p[0]);
+    const __m256i last = _mm256_set1_epi8(p[k - 1]);
+
+    size_t i = 0;
+    for (; i + k - 1 + 32 <= n; i += 32) {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + k - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(s + i + bit + 1, p + 1, k - 2) == 0)
+                return true;
+            mask &= mask - 1;
+        }
+    }
+    // o resto (menos de 32 + k posições) pela versão de 16
+    return find_sse2(s + i, n - i, p, k);
+}
+
+#endif
+
+struct Dispatch {
+    FindFn find;
+    const char* isa;
+};
+
+Dispatch select() {
+#ifdef MYKAFKA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return {find_avx2, "avx2"};
+#if defined(__SSE2__)
+    return {find_sse2, "sse2"};
+#else
+    if (__builtin_cpu_supports("sse2"))
+        return {find_sse2, "sse2"};
+#endif
+#endif
+    return {find_scalar, "scalar"};
+}
+
+const Dispatch dispatch = select();
+
+} // namespace
+
+bool contains(std::string_view haystack, std::string_view needle) {
+    if (needle.empty())
+        return true;
+    if (needle.size() > haystack.size())
+        return false;
+    if (needle.size() == 1)
+        return std::memchr(haystack.data(), needle[0], haystack.size()) != nullptr;
+    return dispatch.find(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+const char* pattern_search_isa() {
+    return dispatch.isa;
+}
+
+} // namespace mykafka
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace mykafka {
+
+// Busca de substring vetorizada (primeiro e último byte do padrão comparados
+// 16/32 posições por vez; candidatos confirmados com memcmp). A versão é
+// escolhida uma vez, na carga, conforme a CPU: AVX2, SSE2 ou escalar.
+bool contains(std::string_view haystack, std::string_view needle);
+
+// "avx2", "sse2" ou "scalar"
+const char* pattern_search_isa();
+
+} // namespace mykafka
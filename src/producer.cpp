@@ -1,61 +1,293 @@
 #include "producer.hpp"
+#include "consumer.hpp"
+#include "stats_collector.hpp"
+#include "spill_log.hpp"
 #include <librdkafka/rdkafka.h>
 #include <stdexcept>
-#ifdef ASYNC_MODE
-  #include <thread>
-  #include <atomic>
-#endif
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace mykafka {
 
+// Registro dos handles de tópico (rd_kafka_topic_t) do Producer.
+// Cada tópico é criado uma única vez e reaproveitado por todas as threads;
+// os handles só são destruídos junto com o registro, antes do rd_kafka_destroy.
+class TopicRegistry {
+public:
+    struct Entry {
+        std::string name;
+        rd_kafka_topic_t* rkt{};
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> errors{0};
+        LatencyHistogram delivery_latency; // send → relatório de entrega
+    };
+
+    explicit TopicRegistry(rd_kafka_t* rk) : rk_(rk), id_(next_id()) {}
+
+    ~TopicRegistry() {
+        for (auto& kv : topics_)
+            rd_kafka_topic_destroy(kv.second->rkt);
+    }
+
+    TopicRegistry(const TopicRegistry&) = delete;
+    TopicRegistry& operator=(const TopicRegistry&) = delete;
+
+    Entry& get(const std::string& topic) {
+        // Caminho rápido: cada thread lembra o último tópico usado,
+        // sem lock nem hash. O id distingue registros de Producers diferentes.
+        thread_local struct {
+            uint64_t registry_id = 0;
+            std::string topic;
+            Entry* entry = nullptr;
+        } last;
+
+        if (last.registry_id == id_ && last.topic == topic)
+            return *last.entry;
+
+        Entry* entry = lookup(topic);
+        last.registry_id = id_;
+        last.topic = topic;
+        last.entry = entry;
+        return *entry;
+    }
+
+    std::vector<TopicCounters> counters() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<TopicCounters> out;
+        out.reserve(topics_.size());
+        for (const auto& kv : topics_) {
+            const Entry& e = *kv.second;
+            out.push_back({e.name, e.messages.load(std::memory_order_relaxed),
+                           e.bytes.load(std::memory_order_relaxed),
+                           e.errors.load(std::memory_order_relaxed)});
+        }
+        return out;
+    }
+
+    std::vector<TopicLatency> latencies() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<TopicLatency> out;
+        out.reserve(topics_.size());
+        for (const auto& kv : topics_)
+            out.push_back({kv.second->name, kv.second->delivery_latency.snapshot()});
+        return out;
+    }
+
+    // Recupera a entrada a partir do handle (usado no dr_msg_cb)
+    static Entry* from_handle(const rd_kafka_topic_t* rkt) {
+        return rkt ? static_cast<Entry*>(rd_kafka_topic_opaque(rkt)) : nullptr;
+    }
+
+private:
+    Entry* lookup(const std::string& topic) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = topics_.find(topic);
+            if (it != topics_.end())
+                return it->second.get();
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = topics_.find(topic);
+        if (it != topics_.end())
+            return it->second.get();
+
+        auto entry = std::make_unique<Entry>();
+        entry->name = topic;
+
+        // o opaque do tópico aponta para a entrada, para contabilizar erros de entrega.
+        // Parte da configuração padrão: propriedades de tópico (acks, partitioner,
+        // compression.type...) definidas no ClientConfig valem aqui também.
+        rd_kafka_topic_conf_t* tconf = rd_kafka_default_topic_conf_dup(rk_);
+        rd_kafka_topic_conf_set_opaque(tconf, entry.get());
+
+        entry->rkt = rd_kafka_topic_new(rk_, topic.c_str(), tconf);
+        if (!entry->rkt)
+            throw std::runtime_error("Failed to create topic: " + topic);
+
+        Entry* raw = entry.get();
+        topics_.emplace(topic, std::move(entry));
+        return raw;
+    }
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    rd_kafka_t* rk_;
+    const uint64_t id_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Entry>> topics_;
+};
+
+// Contexto de cada mensagem, levado no opaque até o dr_msg_cb
+// (um único contexto é compartilhado por todas as mensagens de um send_batch).
+struct MessageContext {
+    Producer::DeliveryCallback callback;
+    Buffer payload; // dono da memória enviada sem cópia (pode estar vazio)
+    std::atomic<uint32_t> pending{1}; // relatórios de entrega ainda esperados
+    MessageContext* next = nullptr;   // encadeamento na lista livre do pool
+
+    // devolve true quando o último relatório chegou e o contexto pode voltar ao pool
+    bool done(uint32_t n = 1) {
+        return pending.fetch_sub(n, std::memory_order_acq_rel) == n;
+    }
+};
+
+// Pool de contextos de mensagem: evita um new/delete por mensagem, feitos em
+// threads diferentes (quem envia aloca, quem serve os relatórios libera).
+// Os contextos vêm de blocos pré-alocados. A devolução é lock-free (push numa
+// pilha atômica); a retirada usa um mutex e, quando a lista local esvazia,
+// pega de uma só vez tudo o que foi devolvido.
+class ContextPool {
+public:
+    MessageContext* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_)
+            free_ = returned_.exchange(nullptr, std::memory_order_acquire);
+        if (!free_)
+            grow();
+
+        MessageContext* ctx = free_;
+        free_ = ctx->next;
+        ctx->next = nullptr;
+        ctx->pending.store(1, std::memory_order_relaxed);
+        return ctx;
+    }
+
+    void release(MessageContext* ctx) {
+        // destrói o estado capturado pelo callback e devolve o payload ao dono
+        ctx->callback = nullptr;
+        ctx->payload = Buffer();
+
+        MessageContext* head = returned_.load(std::memory_order_relaxed);
+        do {
+            ctx->next = head;
+        } while (!returned_.compare_exchange_weak(head, ctx,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+
+private:
+    void grow() {
+        auto chunk = std::make_unique<MessageContext[]>(kChunkSize);
+        for (size_t i = 0; i < kChunkSize; ++i) {
+            chunk[i].next = free_;
+            free_ = &chunk[i];
+        }
+        chunks_.push_back(std::move(chunk));
+    }
+
+    static constexpr size_t kChunkSize = 1024;
+
+    std::mutex mutex_;
+    MessageContext* free_ = nullptr;                // protegido por mutex_
+    std::atomic<MessageContext*> returned_{nullptr}; // devolvidos por quem serve os relatórios
+    std::vector<std::unique_ptr<MessageContext[]>> chunks_;
+};
+
 class Producer::Impl {
 public:
     rd_kafka_t* rk{};
     rd_kafka_conf_t* conf{};
-#ifdef ASYNC_MODE    
-    rd_kafka_queue_t* queue{};
+    std::unique_ptr<TopicRegistry> topics;
+    ContextPool contexts;
+    StatsCollector statistics;
+
+    // --- relatórios de entrega ---
+    DeliveryOptions delivery;
+    rd_kafka_queue_t* queue{};        // fila principal, servida pela event_thread ou pelo drain()
     std::thread event_thread;
+    int event_fd = -1;                // modo EventLoop: sinalizado quando a fila recebe eventos
     std::atomic<bool> running{true}; 
-#endif   
 
-    Impl(const std::string& brokers, const std::string& ssl_ca, const std::string& ssl_cert, const std::string& ssl_key) 
+    // modo Executor: relatórios do evento atual e tarefas ainda não executadas
+    struct PendingReport {
+        MessageContext* ctx;
+        DeliveryReport report;
+    };
+    std::vector<PendingReport> dispatch_batch;  // só usado pela event_thread
+    std::mutex dispatch_mutex;
+    std::condition_variable dispatch_cv;
+    size_t dispatch_pending = 0;
+
+    // --- backpressure ---
+    // Quem não tem espaço espera pelo próximo lote de relatórios: 'progress'
+    // muda a cada lote e 'space_waiters' evita o notify quando ninguém espera.
+    std::atomic<uint64_t> in_flight_bytes{0}; // só contado com max_in_flight_bytes
+    std::atomic<uint64_t> progress{0};
+    std::atomic<int> space_waiters{0};
+    std::mutex space_mutex;
+    std::condition_variable space_cv;
+
+    // --- transbordo em disco (SpillOptions) ---
+    // spill_mutex mantém o log e os callbacks na mesma ordem
+    std::unique_ptr<SpillLog> spill;
+    std::mutex spill_mutex;
+    std::deque<Producer::DeliveryCallback> spill_callbacks; // um por registro gravado por este Producer
+    uint64_t recovered_left = 0; // registros de uma execução anterior, sem callback (vêm primeiro)
+    std::atomic<uint64_t> spilled{0};
+    std::atomic<uint64_t> replayed{0};
+    std::thread replay_thread;
+    std::atomic<bool> replaying{true};
+    std::mutex replay_mutex;
+    std::condition_variable replay_cv;
+
+    // até quando um envio sem espaço pode esperar
+    using Deadline = std::chrono::steady_clock::time_point;
+    static constexpr Deadline kForever = Deadline::max();
+
+    Impl(const ClientConfig& config, const DeliveryOptions& delivery_options)
+        : delivery(delivery_options)
     {
-        char errstr[512];
+        if (delivery.mode == DeliveryMode::Executor && !delivery.executor)
+            throw std::invalid_argument("DeliveryMode::Executor requer um executor");
 
-        conf = rd_kafka_conf_new();
+        char errstr[512];
 
-        // bootstrap
-        if (rd_kafka_conf_set(conf, "bootstrap.servers",
-                              brokers.c_str(),
-                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK)
-        {
-            throw std::runtime_error(errstr);
+        if (!delivery.spill.directory.empty()) {
+            // mensagens transbordadas sairiam fora da transação
+            if (!config.get("transactional.id").empty())
+                throw std::invalid_argument("SpillOptions não pode ser usado com transactional.id");
+            // recupera o que ficou de uma execução anterior antes de criar o cliente
+            spill = std::make_unique<SpillLog>(delivery.spill.directory, delivery.spill.segment_bytes);
+            recovered_left = spill->recovered();
         }
 
-        // --- SSL (somente se fornecido) ---
-        if (!ssl_ca.empty()) {
-            rd_kafka_conf_set(conf, "security.protocol", "SSL", nullptr, 0);
-            // Desabilitar a validação de hostname se você usou IP no certificado.
-            // Certificado do broker usa apenas o IP no CN/SAN e nao um hostname valido. 
-            rd_kafka_conf_set(conf, "ssl.endpoint.identification.algorithm", "none", nullptr, 0);            
-            rd_kafka_conf_set(conf, "ssl.ca.location", ssl_ca.c_str(), nullptr, 0);
-        }
+        conf = rd_kafka_conf_new();
 
-        if (!ssl_cert.empty()) {
-            rd_kafka_conf_set(conf, "ssl.certificate.location",
-                            ssl_cert.c_str(), nullptr, 0);
+        // bootstrap, SSL e ajustes de desempenho; valores inválidos viram exceção
+        try {
+            config.apply(conf, ClientConfig::Scope::Producer);
+        } catch (...) {
+            rd_kafka_conf_destroy(conf);
+            throw;
         }
 
-        if (!ssl_key.empty()) {
-            rd_kafka_conf_set(conf, "ssl.key.location",
-                            ssl_key.c_str(), nullptr, 0);
+        if (delivery.mode == DeliveryMode::Inline) {
+            // relatórios via callback, servidos pelo rd_kafka_poll de quem envia
+            rd_kafka_conf_set_dr_msg_cb(conf, dr_msg_cb);
+        } else {
+            // relatórios como eventos, em lotes, na fila principal. Nesse modo o
+            // rd_kafka_flush só espera a fila esvaziar e quem serve é a event_thread.
+            // Estatísticas e erros também viram eventos (o stats_cb não é chamado).
+            rd_kafka_conf_set_events(conf, RD_KAFKA_EVENT_DR | RD_KAFKA_EVENT_STATS | RD_KAFKA_EVENT_ERROR);
         }
-        // -----------------------------------  
-        
-#ifdef ASYNC_MODE
-        rd_kafka_conf_set_dr_msg_cb(conf, dr_msg_cb);
-#endif
+        rd_kafka_conf_set_stats_cb(conf, stats_cb);
+        rd_kafka_conf_set_opaque(conf, this);
         
         // -----------------------------------
 
@@ -63,162 +295,1001 @@ public:
         if (!rk) 
           throw std::runtime_error(errstr);
 
-#ifdef ASYNC_MODE
-        // FORÇA a librdkafka a enviar relatórios de entrega para a fila principal 
-        // que o rd_kafka_poll(rk) consome.
-        rd_kafka_set_log_level(rk, 7); // Debug (opcional para ver o que ocorre)
-
-        // A librdkafka já tem uma fila principal. Usamos o poll(rk) nela.
-        event_thread = std::thread([this]() {
-            while (running || rd_kafka_outq_len(rk) > 0) 
-            {   
-                // Garante processar pendentes
-                rd_kafka_poll(rk, 100); 
-                std::cout << "Passou aqui na thread" << std::endl;
+        topics = std::make_unique<TopicRegistry>(rk);
+
+        if (delivery.mode != DeliveryMode::Inline)
+            queue = rd_kafka_queue_get_main(rk);
+
+        if (delivery.mode == DeliveryMode::EventLoop) {
+            event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (event_fd < 0) {
+                rd_kafka_queue_destroy(queue);
+                topics.reset();
+                rd_kafka_destroy(rk);
+                throw std::runtime_error("Erro criando eventfd");
             }
-        });
-#endif        
+            // a librdkafka escreve no fd quando a fila passa de vazia para não vazia
+            static const uint64_t one = 1;
+            rd_kafka_queue_io_event_enable(queue, event_fd, &one, sizeof(one));
+        } else if (delivery.mode != DeliveryMode::Inline) {
+            event_thread = std::thread([this]() { event_loop(); });
+        }
+
+        if (spill)
+            replay_thread = std::thread([this]() { replay_loop(); });
     }
 
     ~Impl() 
     {
-#ifdef ASYNC_MODE
-        running = false;   // Avisa a thread para parar, mas ela verificará a fila no loop acima
-        // Aguarda a thread de eventos processar os últimos callbacks
-        if (event_thread.joinable())
-            event_thread.join();
-#endif
-        // O flush força o envio e internamente chama o poll para os callbacks pendentes
-        // Se o outq_len já for 0 (porque o usuário chamou flush antes), 
-        // este rd_kafka_flush retornará instantaneamente.
+        // o que ainda está no disco fica lá para o próximo Producer
+        if (replay_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(replay_mutex);
+                replaying = false;
+            }
+            replay_cv.notify_all();
+            replay_thread.join();
+        }
+
+        // Tenta entregar o que falta. No modo Inline o flush serve os callbacks;
+        // nos outros ele só espera a event_thread.
+        // Se o outq_len já for 0 (porque o usuário chamou flush antes), nada é feito.
+        if (rd_kafka_outq_len(rk) > 0) {
+            flush_queue(3000);
+        }
+
+        // O que sobrou é descartado, mas passando pelos relatórios (com erro de purge)
+        // para que callbacks e buffers sem cópia não vazem
         if (rd_kafka_outq_len(rk) > 0) {
-            rd_kafka_flush(rk, 3000); 
+            rd_kafka_purge(rk, RD_KAFKA_PURGE_F_QUEUE | RD_KAFKA_PURGE_F_INFLIGHT);
+            flush_queue(1000);
         }
 
+        if (event_thread.joinable()) {
+            running = false;
+            rd_kafka_queue_yield(queue); // acorda o rd_kafka_queue_poll bloqueado
+            event_thread.join();
+        }
+
+        // os contextos em uso pelo executor pertencem a este Impl
+        {
+            std::unique_lock<std::mutex> lock(dispatch_mutex);
+            dispatch_cv.wait(lock, [this]() { return dispatch_pending == 0; });
+        }
+
+        if (event_fd >= 0)
+            rd_kafka_queue_io_event_enable(queue, -1, nullptr, 0);
+        if (queue)
+            rd_kafka_queue_destroy(queue);
+        if (event_fd >= 0)
+            close(event_fd);
+
+        // handles de tópico precisam ser liberados antes do rd_kafka_t
+        topics.reset();
         rd_kafka_destroy(rk);
     }
 
+    // Loop da thread dedicada: bloqueia na fila até chegar um lote de relatórios
+    void event_loop() {
+        while (running.load(std::memory_order_acquire)) {
+            rd_kafka_event_t* ev = rd_kafka_queue_poll(queue, -1);
+            if (!ev)
+                continue; // rd_kafka_queue_yield
+            handle_event(ev);
+        }
+    }
+
+    // Trata (e destrói) um evento da fila principal; retorna quantos relatórios havia nele
+    size_t handle_event(rd_kafka_event_t* ev) {
+        size_t reports = 0;
+        switch (rd_kafka_event_type(ev)) {
+        case RD_KAFKA_EVENT_DR: {
+            const rd_kafka_message_t* msgs[256];
+            size_t n;
+            while ((n = rd_kafka_event_message_array(ev, msgs, 256)) > 0) {
+                for (size_t i = 0; i < n; ++i)
+                    on_delivery(msgs[i]);
+                reports += n;
+            }
+            if (!dispatch_batch.empty())
+                dispatch();
+            notify_progress();
+            break;
+        }
+        case RD_KAFKA_EVENT_STATS: {
+            const char* json = rd_kafka_event_stats(ev);
+            statistics.store(json, std::strlen(json));
+            break;
+        }
+        case RD_KAFKA_EVENT_ERROR:
+            std::cerr << "Erro no producer: " << rd_kafka_event_error_string(ev) << std::endl;
+            break;
+        default:
+            break;
+        }
+        rd_kafka_event_destroy(ev);
+        return reports;
+    }
+
+    // Modo EventLoop: zera o eventfd e esvazia a fila. O fd só é sinalizado
+    // de novo quando a fila volta a receber eventos, por isso ela precisa
+    // ficar vazia aqui. Espera até 'timeout_ms' pelo primeiro evento.
+    size_t drain(int timeout_ms = 0) {
+        if (delivery.mode != DeliveryMode::EventLoop)
+            return 0;
+
+        uint64_t counter;
+        while (read(event_fd, &counter, sizeof(counter)) == sizeof(counter)) {
+        }
+
+        size_t reports = 0;
+        while (rd_kafka_event_t* ev = rd_kafka_queue_poll(queue, timeout_ms)) {
+            reports += handle_event(ev);
+            timeout_ms = 0;
+        }
+        return reports;
+    }
+
+    static DeliveryReport make_report(const rd_kafka_message_t* msg) {
+        DeliveryReport report;
+        report.success   = (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR);
+        report.error     = rd_kafka_err2str(msg->err);
+        report.partition = msg->partition;
+        report.offset    = msg->offset;
+        return report;
+    }
+
+    // Tratamento comum dos relatórios, venham do dr_msg_cb ou de um evento
+    void on_delivery(const rd_kafka_message_t* msg) {
+        release_bytes(msg->len);
+
+        if (auto* entry = TopicRegistry::from_handle(msg->rkt)) {
+            if (msg->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                entry->errors.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                // a librdkafka marca o instante do produce(); a latência vai até agora
+                int64_t us = rd_kafka_message_latency(msg);
+                if (us >= 0)
+                    entry->delivery_latency.record(static_cast<uint64_t>(us));
+            }
+        }
+
+        // O contexto (callback + dono do payload) está no opaque da mensagem
+        auto* ctx = static_cast<MessageContext*>(msg->_private);
+        if (!ctx) 
+        {
+            // mensagem enviada sem callback e com cópia
+            return;
+        }
+
+        if (ctx->callback) {
+            if (delivery.mode == DeliveryMode::Executor) {
+                dispatch_batch.push_back({ctx, make_report(msg)});
+                return;
+            }
+            ctx->callback(make_report(msg));
+        }
+        finish(ctx);
+    }
+
+    // um relatório a menos para o contexto; o último o devolve ao pool
+    void finish(MessageContext* ctx) {
+        if (ctx->done())
+            contexts.release(ctx); // libera também o payload sem cópia
+    }
+
+    // Entrega ao executor, numa única tarefa, os relatórios do evento atual
+    void dispatch() {
+        {
+            std::lock_guard<std::mutex> lock(dispatch_mutex);
+            ++dispatch_pending;
+        }
+
+        std::vector<PendingReport> reports;
+        reports.swap(dispatch_batch);
+        dispatch_batch.reserve(reports.size());
+
+        delivery.executor([this, reports = std::move(reports)]() {
+            for (const auto& r : reports) {
+                r.ctx->callback(r.report);
+                finish(r.ctx);
+            }
+            std::lock_guard<std::mutex> lock(dispatch_mutex);
+            --dispatch_pending;
+            dispatch_cv.notify_all();
+        });
+    }
+
+    // Mensagem recusada no enfileiramento: a librdkafka não gera relatório,
+    // então avisamos na hora e liberamos o contexto aqui mesmo.
+    void fail(MessageContext* ctx, const std::string& error) {
+        if (!ctx)
+            return;
+        if (ctx->callback) {
+            DeliveryReport report;
+            report.success = false;
+            report.error = error;
+            report.partition = -1;
+            report.offset = -1;
+            ctx->callback(report);
+        }
+        finish(ctx);
+    }
+
+    // Descarta o contexto de uma mensagem recusada sem chamar o callback
+    // (quem enviou já recebe o erro no SendResult)
+    void discard(MessageContext* ctx) {
+        if (!ctx)
+            return;
+        ctx->callback = nullptr;
+        finish(ctx);
+    }
+
+    // Reserva bytes do max_in_flight_bytes. Uma mensagem sozinha sempre passa,
+    // mesmo maior que o limite, para não travar para sempre.
+    bool reserve_bytes(size_t size) {
+        if (delivery.max_in_flight_bytes == 0)
+            return true;
+        uint64_t current = in_flight_bytes.load(std::memory_order_relaxed);
+        do {
+            if (current > 0 && current + size > delivery.max_in_flight_bytes)
+                return false;
+        } while (!in_flight_bytes.compare_exchange_weak(current, current + size,
+                                                        std::memory_order_relaxed));
+        return true;
+    }
+
+    void release_bytes(size_t size) {
+        if (delivery.max_in_flight_bytes == 0)
+            return;
+        in_flight_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    // Acorda quem espera por espaço: chamado a cada lote de relatórios
+    void notify_progress() {
+        progress.fetch_add(1);
+        if (space_waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(space_mutex);
+            space_cv.notify_all();
+        }
+    }
+
+    // Espera os relatórios andarem desde 'seen' (ou o prazo vencer).
+    // Nos modos Inline e EventLoop quem espera serve os relatórios, o que libera
+    // a fila; sem 'serve' (thread do transbordo) só espera: os callbacks desses
+    // modos rodam apenas na thread do chamador.
+    bool wait_for_space(uint64_t seen, Deadline deadline, bool serve = true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return false;
+
+        if (serve && (delivery.mode == DeliveryMode::Inline || delivery.mode == DeliveryMode::EventLoop)) {
+            auto slice = std::chrono::milliseconds(10);
+            if (deadline - now < slice)
+                slice = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+            if (delivery.mode == DeliveryMode::Inline)
+                rd_kafka_poll(rk, static_cast<int>(slice.count()));
+            else
+                drain(static_cast<int>(slice.count()));
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(space_mutex);
+        ++space_waiters;
+        // a fatia de 100 ms só protege contra um relatório que nunca chegue
+        auto until = deadline == kForever ? now + std::chrono::milliseconds(100)
+                                          : std::min(deadline, now + std::chrono::milliseconds(100));
+        space_cv.wait_until(lock, until, [&]() { return progress.load() != seen; });
+        --space_waiters;
+        return true;
+    }
+
     void send(const std::string& topic, const std::string& message, Producer::DeliveryCallback callback)
     {
-#ifdef ASYNC_MODE
-        send_async(topic, message, callback);
-#else
-        rd_kafka_topic_t* rkt = rd_kafka_topic_new(rk, topic.c_str(), nullptr);
-        if (!rkt)
-            throw std::runtime_error("Failed to create topic");
-
-        int err = rd_kafka_produce(
-            rkt,
-            RD_KAFKA_PARTITION_UA,
-            RD_KAFKA_MSG_F_COPY,
-            (void*)message.c_str(),
-            message.size(),
-            nullptr,
-            0,
-            nullptr);
-
-        rd_kafka_poll(rk, 0);
-        rd_kafka_topic_destroy(rkt);
+        produce(topic, message.data(), message.size(), RD_KAFKA_MSG_F_COPY, Buffer(), std::move(callback));
+    }
 
-        if (callback) {
-            if (err != 0)
-                callback(false, rd_kafka_err2str(rd_kafka_last_error()));
+    // Núcleo do envio. Sem RD_KAFKA_MSG_F_COPY a librdkafka apenas referencia
+    // 'data'; nesse caso 'owner' (se houver) mantém a memória viva e é liberado
+    // junto com o contexto, no relatório de entrega ou aqui, se a mensagem não for aceita.
+    //
+    // Sem espaço, espera até 'deadline'. Com 'report_refusal', uma recusa chama
+    // o callback (send); sem, só é devolvida (try_send/send_for).
+    // 'record' (opcional) traz chave, partição, timestamp e cabeçalhos.
+    rd_kafka_resp_err_t produce(const std::string& topic, const void* data, size_t size, int msgflags,
+                                Buffer owner, Producer::DeliveryCallback callback,
+                                Deadline deadline = kForever, bool report_refusal = true,
+                                const ProducerRecord* record = nullptr, bool from_spill = false)
+    {
+        // em transbordo (ou com a fila acima da marca) a mensagem vai para o disco,
+        // atrás das que já estão lá
+        if (spill && !from_spill &&
+            (spill->active() || rd_kafka_outq_len(rk) >= static_cast<int>(delivery.spill.watermark_messages)))
+            return spill_message(topic, data, size, record, callback, report_refusal);
+
+        TopicRegistry::Entry& entry = topics->get(topic);
+
+        // caminho rápido: sem callback e com cópia não há contexto algum
+        MessageContext* ctx = nullptr;
+        if (callback || owner) {
+            ctx = contexts.acquire();
+            ctx->callback = std::move(callback); // std::function pequeno fica inline, sem alocar
+            ctx->payload = std::move(owner);
+        }
+
+        // a lista de cabeçalhos passa a ser da librdkafka quando a mensagem é aceita
+        rd_kafka_headers_t* headers = record ? make_headers(*record) : nullptr;
+
+        rd_kafka_resp_err_t err;
+        for (;;) {
+            uint64_t seen = progress.load();
+            if (!reserve_bytes(size)) {
+                err = RD_KAFKA_RESP_ERR__QUEUE_FULL;
+            } else {
+                // Capturamos o retorno para saber se a mensagem foi aceita para envio
+                if (!record) {
+                    err = rd_kafka_producev(
+                            rk,
+                            RD_KAFKA_V_RKT(entry.rkt),
+                            RD_KAFKA_V_MSGFLAGS(msgflags),
+                            RD_KAFKA_V_VALUE(const_cast<void*>(data), size),
+                            RD_KAFKA_V_OPAQUE(ctx), // Macro correta para a API producev
+                            RD_KAFKA_V_END
+                        );
+                } else {
+                    err = produce_record(entry, *record, data, size, msgflags, headers, ctx);
+                }
+                if (err == RD_KAFKA_RESP_ERR_NO_ERROR)
+                    headers = nullptr;
+                else
+                    release_bytes(size);
+            }
+
+            // fila cheia antes da marca (ex.: queue.buffering.max.kbytes): transborda em vez de esperar
+            if (err == RD_KAFKA_RESP_ERR__QUEUE_FULL && spill && !from_spill) {
+                if (headers)
+                    rd_kafka_headers_destroy(headers);
+                if (ctx)
+                    callback = std::move(ctx->callback);
+                err = spill_message(topic, data, size, record, callback, report_refusal);
+                discard(ctx); // só agora: o payload sem cópia já foi gravado
+                return err;
+            }
+
+            if (err != RD_KAFKA_RESP_ERR__QUEUE_FULL || !wait_for_space(seen, deadline, !from_spill))
+                break;
+        }
+
+        if (headers)
+            rd_kafka_headers_destroy(headers);
+
+        if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            entry.messages.fetch_add(1, std::memory_order_relaxed);
+            entry.bytes.fetch_add(size, std::memory_order_relaxed);
+        } else {
+            entry.errors.fetch_add(1, std::memory_order_relaxed);
+            if (report_refusal)
+                fail(ctx, rd_kafka_err2str(err));
             else
-                callback(true, "");
+                discard(ctx);
         }
-#endif
+
+        if (delivery.mode == DeliveryMode::Inline && !from_spill)
+            rd_kafka_poll(rk, 0);
+        return err;
     }
 
-#ifdef ASYNC_MODE
-void send_async(const std::string& topic, const std::string& message, DeliveryCallback callback) 
-{
-    auto* cb_ptr = new mykafka::Producer::DeliveryCallback(std::move(callback));
+    // Grava a mensagem no log em disco; o callback espera o reenvio.
+    // Falha de E/S é tratada como recusa do envio.
+    rd_kafka_resp_err_t spill_message(const std::string& topic, const void* data, size_t size,
+                                      const ProducerRecord* record, Producer::DeliveryCallback& callback,
+                                      bool report_refusal) {
+        ProducerRecord plain;
+        if (!record) {
+            plain.topic = topic;
+            record = &plain;
+        }
+        // o timestamp é o do send, não o do reenvio
+        int64_t timestamp_ms = record->timestamp_ms;
+        if (timestamp_ms == 0)
+            timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
 
-    // Capturamos o retorno para saber se a mensagem foi aceita para envio
-    rd_kafka_resp_err_t err = rd_kafka_producev(
-            rk,
-            RD_KAFKA_V_TOPIC(topic.c_str()),
-            RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
-            RD_KAFKA_V_VALUE((void*)message.data(), message.size()),
-            RD_KAFKA_V_OPAQUE(cb_ptr), // Macro correta para a API producev
-            RD_KAFKA_V_END
-        );
+        try {
+            std::lock_guard<std::mutex> lock(spill_mutex);
+            spill->append(*record, std::string_view(static_cast<const char*>(data), size), timestamp_ms);
+            spill_callbacks.push_back(std::move(callback));
+        } catch (const std::exception& e) {
+            topics->get(topic).errors.fetch_add(1, std::memory_order_relaxed);
+            if (report_refusal && callback) {
+                DeliveryReport report;
+                report.success = false;
+                report.error = e.what();
+                report.partition = -1;
+                report.offset = -1;
+                callback(report);
+            }
+            return RD_KAFKA_RESP_ERR__FAIL;
+        }
+        spilled.fetch_add(1, std::memory_order_relaxed);
+        return RD_KAFKA_RESP_ERR_NO_ERROR;
+    }
 
-    // Se err != 0, a librdkafka NÃO chamará o dr_msg_cb. 
-    // Precisamos tratar o erro e limpar a memória manualmente aqui.
-    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
-        DeliveryReport report;
-        report.success = false;
-        report.error = rd_kafka_err2str(err);
-        report.partition = -1;
-        report.offset = -1;
-        
-        if (cb_ptr) {
-            (*cb_ptr)(report);
-            delete cb_ptr;
+    // Thread do transbordo: reenvia o log, em ordem, enquanto a fila da
+    // librdkafka estiver abaixo da marca; abaixo da metade dela, recomeça.
+    void replay_loop() {
+        const int high = static_cast<int>(std::max<size_t>(delivery.spill.watermark_messages, 1));
+        const int low = std::max(high / 2, 1);
+        ProducerRecord record;
+
+        while (replaying.load()) {
+            if (!spill->active() || rd_kafka_outq_len(rk) >= low) {
+                std::unique_lock<std::mutex> lock(replay_mutex);
+                replay_cv.wait_for(lock, std::chrono::milliseconds(20), [this]() { return !replaying.load(); });
+                continue;
+            }
+
+            while (replaying.load() && rd_kafka_outq_len(rk) < high) {
+                SpillLog::Segment* segment;
+                uint64_t position;
+                Producer::DeliveryCallback callback;
+                {
+                    std::lock_guard<std::mutex> lock(spill_mutex);
+                    segment = spill->peek(record, position);
+                    if (!segment) {
+                        spill->drained(); // sob o spill_mutex: nenhum send grava entre o peek e aqui
+                        break;
+                    }
+                    if (recovered_left == 0)
+                        callback = spill_callbacks.front(); // só sai da fila se for aceito
+                }
+
+                // O segmento só é apagado depois do relatório de cada mensagem dele.
+                // Falhas no encerramento (purge do destrutor) não contam: o segmento
+                // fica no disco e é reenviado pelo próximo Producer.
+                auto on_delivery = [this, segment, position, callback](const DeliveryReport& report) {
+                    if (report.success || !replaying.load()) {
+                        if (callback)
+                            callback(report);
+                        if (report.success)
+                            spill->delivered(segment);
+                        return;
+                    }
+                    if (callback) {
+                        callback(report); // quem enviou decide se tenta de novo
+                        spill->delivered(segment);
+                        return;
+                    }
+                    // recuperada do disco, sem ninguém para avisar: volta para o fim do log
+                    try {
+                        std::lock_guard<std::mutex> lock(spill_mutex);
+                        spill->requeue(segment, position);
+                        spill_callbacks.emplace_back(); // mantém a fila alinhada com o log
+                    } catch (const std::exception& e) {
+                        spill->dropped(segment, report.error + "; " + e.what());
+                    }
+                };
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+                rd_kafka_resp_err_t err = produce(record.topic, record.value.data(), record.value.size(),
+                                                  RD_KAFKA_MSG_F_COPY, Buffer(), on_delivery,
+                                                  deadline, false, &record, true);
+                if (err == RD_KAFKA_RESP_ERR__QUEUE_FULL)
+                    break; // tenta de novo quando a fila andar
+
+                // consome antes de qualquer relatório poder liberar o segmento
+                {
+                    std::lock_guard<std::mutex> lock(spill_mutex);
+                    spill->advance(segment);
+                    if (recovered_left > 0)
+                        --recovered_left;
+                    else
+                        spill_callbacks.pop_front();
+                    replayed.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                    // recusa definitiva (ex.: mensagem grande demais): tentar de novo não adianta
+                    if (callback) {
+                        DeliveryReport report;
+                        report.success = false;
+                        report.error = rd_kafka_err2str(err);
+                        report.partition = -1;
+                        report.offset = -1;
+                        callback(report);
+                        spill->delivered(segment);
+                    } else {
+                        spill->dropped(segment, rd_kafka_err2str(err));
+                    }
+                }
+            }
         }
     }
-}
-#endif
 
-    void flush(int timeout_ms) {
-        rd_kafka_flush(rk, timeout_ms);
+    SpillStats spill_stats() const {
+        SpillStats stats;
+        if (!spill)
+            return stats;
+        stats.spilled = spilled.load(std::memory_order_relaxed);
+        stats.replayed = replayed.load(std::memory_order_relaxed);
+        stats.pending = spill->pending();
+        stats.recovered = spill->recovered();
+        stats.lost = spill->lost();
+        stats.segments = spill->segments();
+        return stats;
     }
 
-#ifdef ASYNC_MODE
-    static void dr_msg_cb(rd_kafka_t*,
-                        const rd_kafka_message_t* msg,
-                        void* opaque) {
-        std::cout << "[DEBUG] dr_msg_cb disparado!" << std::endl;
-        std::cout << "[DEBUG] Ponteiro opaque recebido: " << opaque << std::endl;
+    // Nomes e valores vão direto das views do chamador para a lista da
+    // librdkafka (a única cópia, que ela faria de qualquer jeito)
+    static rd_kafka_headers_t* make_headers(const ProducerRecord& record) {
+        if (record.headers.empty())
+            return nullptr;
+        rd_kafka_headers_t* headers = rd_kafka_headers_new(record.headers.size());
+        for (const Header& h : record.headers) {
+            rd_kafka_header_add(headers, h.name.data(), static_cast<ssize_t>(h.name.size()),
+                                h.value.data(), static_cast<ssize_t>(h.value.size()));
+        }
+        return headers;
+    }
 
-        // O seu cb_ptr (DeliveryCallback) está aqui:
-        void* message_opaque = msg->_private; 
+    rd_kafka_resp_err_t produce_record(TopicRegistry::Entry& entry, const ProducerRecord& record,
+                                       const void* data, size_t size, int msgflags,
+                                       rd_kafka_headers_t* headers, MessageContext* ctx)
+    {
+        int32_t partition = record.partition == ANY_PARTITION ? RD_KAFKA_PARTITION_UA : record.partition;
+        // a lista de argumentos do producev é fixa: sem cabeçalhos, sem RD_KAFKA_V_HEADERS
+        if (!headers) {
+            return rd_kafka_producev(
+                    rk,
+                    RD_KAFKA_V_RKT(entry.rkt),
+                    RD_KAFKA_V_MSGFLAGS(msgflags),
+                    RD_KAFKA_V_PARTITION(partition),
+                    RD_KAFKA_V_KEY(record.key.data(), record.key.size()),
+                    RD_KAFKA_V_VALUE(const_cast<void*>(data), size),
+                    RD_KAFKA_V_TIMESTAMP(record.timestamp_ms),
+                    RD_KAFKA_V_OPAQUE(ctx),
+                    RD_KAFKA_V_END
+                );
+        }
+        return rd_kafka_producev(
+                rk,
+                RD_KAFKA_V_RKT(entry.rkt),
+                RD_KAFKA_V_MSGFLAGS(msgflags),
+                RD_KAFKA_V_PARTITION(partition),
+                RD_KAFKA_V_KEY(record.key.data(), record.key.size()),
+                RD_KAFKA_V_VALUE(const_cast<void*>(data), size),
+                RD_KAFKA_V_TIMESTAMP(record.timestamp_ms),
+                RD_KAFKA_V_HEADERS(headers),
+                RD_KAFKA_V_OPAQUE(ctx),
+                RD_KAFKA_V_END
+            );
+    }
 
-        if (!message_opaque) 
-        {
-            // Isso pode acontecer se você enviar uma mensagem sem callback
+    // Enfileira o lote inteiro com uma única chamada a rd_kafka_produce_batch.
+    // 'messages' aponta para 'count' payloads; 'msgflags' decide se são copiados.
+    std::vector<SendResult> send_batch(const std::string& topic, const std::string_view* messages, size_t count,
+                                       int32_t partition, int msgflags, Producer::DeliveryCallback callback)
+    {
+        std::vector<SendResult> results(count);
+        if (count == 0)
+            return results;
+
+        TopicRegistry::Entry& entry = topics->get(topic);
+
+        // array reaproveitado entre chamadas da mesma thread
+        thread_local std::vector<rd_kafka_message_t> batch;
+        batch.assign(count, rd_kafka_message_t{});
+
+        // um único contexto para o lote; sem callback nem é preciso criar
+        MessageContext* ctx = nullptr;
+        if (callback) {
+            ctx = contexts.acquire();
+            ctx->callback = std::move(callback);
+            ctx->pending.store(static_cast<uint32_t>(count), std::memory_order_relaxed);
+        }
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            batch[i].payload  = const_cast<char*>(messages[i].data());
+            batch[i].len      = messages[i].size();
+            batch[i]._private = ctx;
+            total += messages[i].size();
+        }
+
+        // o lote entra inteiro no max_in_flight_bytes
+        for (;;) {
+            uint64_t seen = progress.load();
+            if (reserve_bytes(total))
+                break;
+            wait_for_space(seen, kForever);
+        }
+
+        int accepted = rd_kafka_produce_batch(entry.rkt,
+                                              partition == ANY_PARTITION ? RD_KAFKA_PARTITION_UA : partition,
+                                              msgflags, batch.data(), static_cast<int>(count));
+
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i].err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+                results[i].success = true;
+                bytes += batch[i].len;
+            } else {
+                results[i].success = false;
+                results[i].error = rd_kafka_err2str(batch[i].err);
+            }
+        }
+
+        const size_t failed = count - static_cast<size_t>(accepted);
+        entry.messages.fetch_add(static_cast<uint64_t>(accepted), std::memory_order_relaxed);
+        entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        entry.errors.fetch_add(failed, std::memory_order_relaxed);
+        release_bytes(total - bytes);
+
+        // mensagens recusadas não geram relatório: avisamos aqui e descontamos do contexto
+        if (ctx && failed > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                if (!results[i].success)
+                    fail(ctx, results[i].error);
+            }
+        }
+
+        if (delivery.mode == DeliveryMode::Inline)
+            rd_kafka_poll(rk, 0);
+
+        return results;
+    }
+
+    int poll(int timeout_ms) {
+        if (delivery.mode == DeliveryMode::EventLoop)
+            return static_cast<int>(drain(timeout_ms));
+        if (delivery.mode != DeliveryMode::Inline)
+            return 0;
+        return rd_kafka_poll(rk, timeout_ms);
+    }
+
+    // Espera a fila de saída esvaziar. No modo EventLoop ninguém mais serve os
+    // relatórios (o rd_kafka_flush só esperaria), então o próprio flush drena.
+    void flush_queue(int timeout_ms) {
+        if (delivery.mode != DeliveryMode::EventLoop) {
+            rd_kafka_flush(rk, timeout_ms);
             return;
-        }        
-        
-        auto* cb = static_cast<mykafka::Producer::DeliveryCallback*>(message_opaque);
-        //auto* cb = static_cast<mykafka::Producer::DeliveryCallback*>(opaque);
-        if (!cb) 
-        {
-            std::cout << "[ERRO] Opaque nulo no callback!" << std::endl;
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (rd_kafka_outq_len(rk) > 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0)
+                break;
+            drain(static_cast<int>(std::min<int64_t>(left.count(), 100)));
+        }
+    }
+
+    void flush(int timeout_ms) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+        // o que transbordou também precisa sair: espera o log esvaziar, servindo
+        // os relatórios (modos Inline/EventLoop) para a fila da librdkafka andar
+        while (spill && spill->active()) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0)
+                break;
+            flush_queue(static_cast<int>(std::min<int64_t>(left, 50)));
+            if (rd_kafka_outq_len(rk) == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        flush_queue(static_cast<int>(std::max<int64_t>(left, 0)));
+
+        if (delivery.mode == DeliveryMode::Executor) {
+            std::unique_lock<std::mutex> lock(dispatch_mutex);
+            dispatch_cv.wait_until(lock, deadline, [this]() { return dispatch_pending == 0; });
+        }
+    }
+
+    // ---------- transações ----------
+
+    // Converte o erro da librdkafka (e o libera) em TransactionError
+    static void check(rd_kafka_error_t* error, const char* what) {
+        if (!error)
             return;
+        TransactionError e(std::string(what) + rd_kafka_error_string(error),
+                           rd_kafka_error_is_retriable(error) != 0,
+                           rd_kafka_error_txn_requires_abort(error) != 0,
+                           rd_kafka_error_is_fatal(error) != 0);
+        rd_kafka_error_destroy(error);
+        throw e;
+    }
+
+    void send_offsets_to_transaction(rd_kafka_t* consumer, int timeout_ms) {
+        rd_kafka_topic_partition_list_t* offsets = nullptr;
+        rd_kafka_resp_err_t err = rd_kafka_assignment(consumer, &offsets);
+        if (err == RD_KAFKA_RESP_ERR_NO_ERROR)
+            err = rd_kafka_position(consumer, offsets);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            if (offsets)
+                rd_kafka_topic_partition_list_destroy(offsets);
+            throw TransactionError(std::string("Erro lendo posições do consumer: ") + rd_kafka_err2str(err),
+                                   false, true, false);
         }
 
-        DeliveryReport report;
-        report.success   = (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR);
-        report.error     = rd_kafka_err2str(msg->err);
-        report.partition = msg->partition;
-        report.offset    = msg->offset;
+        // partições sem nada consumido ainda não têm posição
+        rd_kafka_topic_partition_list_t* positions = rd_kafka_topic_partition_list_new(offsets->cnt);
+        for (int i = 0; i < offsets->cnt; ++i) {
+            const rd_kafka_topic_partition_t& tp = offsets->elems[i];
+            if (tp.offset >= 0)
+                rd_kafka_topic_partition_list_add(positions, tp.topic, tp.partition)->offset = tp.offset;
+        }
+        rd_kafka_topic_partition_list_destroy(offsets);
 
-        (*cb)(report);
-        delete cb;
+        rd_kafka_error_t* error = nullptr;
+        if (positions->cnt > 0) {
+            rd_kafka_consumer_group_metadata_t* group = rd_kafka_consumer_group_metadata(consumer);
+            error = rd_kafka_send_offsets_to_transaction(rk, positions, group, timeout_ms);
+            rd_kafka_consumer_group_metadata_destroy(group);
+        }
+        rd_kafka_topic_partition_list_destroy(positions);
+        check(error, "Erro enviando offsets na transação: ");
+    }
+
+    void commit_transaction(int timeout_ms) {
+        // o commit da librdkafka faz um rd_kafka_flush, que no modo EventLoop
+        // só esperaria: os relatórios são servidos aqui antes
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        if (delivery.mode == DeliveryMode::EventLoop)
+            flush_queue(timeout_ms);
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        check(rd_kafka_commit_transaction(rk, static_cast<int>(std::max<int64_t>(left, 0))),
+              "Erro no commit da transação: ");
+    }
+
+    void abort_transaction(int timeout_ms) {
+        // as mensagens não entregues voltam com erro de purge; no modo EventLoop
+        // alguém precisa servir esses relatórios antes do abort esperar por eles
+        if (delivery.mode == DeliveryMode::EventLoop) {
+            rd_kafka_purge(rk, RD_KAFKA_PURGE_F_QUEUE);
+            flush_queue(timeout_ms);
+        }
+        check(rd_kafka_abort_transaction(rk, timeout_ms), "Erro abortando a transação: ");
+    }
+
+    static int stats_cb(rd_kafka_t*, char* json, size_t json_len, void* opaque) {
+        static_cast<Producer::Impl*>(opaque)->statistics.store(json, json_len);
+        return 0; // a librdkafka libera o json
+    }
+
+    static void dr_msg_cb(rd_kafka_t*,
+                        const rd_kafka_message_t* msg,
+                        void* opaque) {
+        static_cast<Producer::Impl*>(opaque)->on_delivery(msg);
     }
-#endif    
 };
 
+// ---------- Buffer ----------
+
+Buffer::Buffer(void* data, size_t size, Deleter deleter, void* ctx)
+    : data_(data), size_(size), deleter_(deleter), ctx_(ctx)
+{
+}
+
+Buffer::Buffer(Buffer&& other) noexcept
+    : data_(other.data_), size_(other.size_), deleter_(other.deleter_), ctx_(other.ctx_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.deleter_ = nullptr;
+    other.ctx_ = nullptr;
+}
+
+Buffer& Buffer::operator=(Buffer&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(deleter_, other.deleter_);
+        std::swap(ctx_, other.ctx_);
+    }
+    return *this;
+}
+
+Buffer::~Buffer()
+{
+    reset();
+}
+
+void Buffer::reset()
+{
+    if (deleter_)
+        deleter_(data_, ctx_);
+    data_ = nullptr;
+    size_ = 0;
+    deleter_ = nullptr;
+    ctx_ = nullptr;
+}
+
+Buffer Buffer::from_malloc(void* data, size_t size)
+{
+    return Buffer(data, size, [](void* p, void*) { std::free(p); });
+}
+
+Buffer Buffer::from_string(std::string&& str)
+{
+    auto* owner = new std::string(std::move(str));
+    return Buffer(owner->data(), owner->size(),
+                  [](void*, void* ctx) { delete static_cast<std::string*>(ctx); }, owner);
+}
+
+Buffer Buffer::from_array(std::unique_ptr<char[]> data, size_t size)
+{
+    return Buffer(data.release(), size, [](void* p, void*) { delete[] static_cast<char*>(p); });
+}
+
 // ---------- Producer ----------
 
 Producer::Producer(const std::string& brokers,
                    const std::string& ssl_ca,
                    const std::string& ssl_cert,
                    const std::string& ssl_key)
-    : impl_(std::make_unique<Impl>(brokers, ssl_ca, ssl_cert, ssl_key)) 
+    : impl_(std::make_unique<Impl>(ClientConfig(brokers).ssl(ssl_ca, ssl_cert, ssl_key), DeliveryOptions())) 
 {
     
 }
 
+Producer::Producer(const std::string& brokers,
+                   const DeliveryOptions& delivery,
+                   const std::string& ssl_ca,
+                   const std::string& ssl_cert,
+                   const std::string& ssl_key)
+    : impl_(std::make_unique<Impl>(ClientConfig(brokers).ssl(ssl_ca, ssl_cert, ssl_key), delivery)) 
+{
+    
+}
+
+Producer::Producer(const ClientConfig& config, const DeliveryOptions& delivery)
+    : impl_(std::make_unique<Impl>(config, delivery))
+{
+}
+
 Producer::~Producer() = default;
 
 void Producer::send(const std::string& topic,
                     const std::string& message,
                     DeliveryCallback callback)
 {
-    impl_->send(topic, message, callback);
+    impl_->send(topic, message, std::move(callback));
+}
+
+void Producer::send(const std::string& topic,
+                    const char* message,
+                    DeliveryCallback callback)
+{
+    impl_->produce(topic, message, std::strlen(message), RD_KAFKA_MSG_F_COPY, Buffer(), std::move(callback));
+}
+
+void Producer::send(const std::string& topic,
+                    std::string&& message,
+                    DeliveryCallback callback)
+{
+    send(topic, Buffer::from_string(std::move(message)), std::move(callback));
+}
+
+void Producer::send(const std::string& topic,
+                    std::unique_ptr<char[]> data,
+                    size_t size,
+                    DeliveryCallback callback)
+{
+    send(topic, Buffer::from_array(std::move(data), size), std::move(callback));
+}
+
+void Producer::send(const std::string& topic,
+                    Buffer buffer,
+                    DeliveryCallback callback)
+{
+    const void* data = buffer.data();
+    size_t size = buffer.size();
+    impl_->produce(topic, data, size, 0, std::move(buffer), std::move(callback));
+}
+
+void Producer::send(const std::string& topic,
+                    std::string_view message,
+                    DeliveryCallback callback)
+{
+    impl_->produce(topic, message.data(), message.size(), 0, Buffer(), std::move(callback));
+}
+
+void Producer::send(const ProducerRecord& record, DeliveryCallback callback)
+{
+    impl_->produce(record.topic, record.value.data(), record.value.size(), RD_KAFKA_MSG_F_COPY,
+                   Buffer(), std::move(callback), Impl::kForever, true, &record);
+}
+
+void Producer::send(const ProducerRecord& record, Buffer value, DeliveryCallback callback)
+{
+    const void* data = value.data();
+    size_t size = value.size();
+    impl_->produce(record.topic, data, size, 0, std::move(value), std::move(callback),
+                   Impl::kForever, true, &record);
+}
+
+std::vector<SendResult> Producer::send_batch(const std::string& topic,
+                                             const std::vector<std::string>& messages,
+                                             int32_t partition,
+                                             DeliveryCallback callback)
+{
+    // só as views mudam de mãos; os bytes são copiados pela librdkafka
+    std::vector<std::string_view> views(messages.begin(), messages.end());
+    return impl_->send_batch(topic, views.data(), views.size(), partition,
+                             RD_KAFKA_MSG_F_COPY, std::move(callback));
+}
+
+std::vector<SendResult> Producer::send_batch(const std::string& topic,
+                                             const std::string_view* messages,
+                                             size_t count,
+                                             int32_t partition,
+                                             DeliveryCallback callback)
+{
+    return impl_->send_batch(topic, messages, count, partition, 0, std::move(callback));
+}
+
+void Producer::send_async(const std::string& topic, const std::string& message, DeliveryCallback callback)
+{
+    impl_->send(topic, message, std::move(callback));
+}
+
+void Producer::send_async(const std::string& topic, const char* message, DeliveryCallback callback)
+{
+    send(topic, message, std::move(callback));
+}
+
+void Producer::send_async(const std::string& topic, std::string&& message, DeliveryCallback callback)
+{
+    send(topic, std::move(message), std::move(callback));
+}
+
+void Producer::send_async(const std::string& topic, Buffer buffer, DeliveryCallback callback)
+{
+    send(topic, std::move(buffer), std::move(callback));
+}
+
+void Producer::send_async(const std::string& topic, std::string_view message, DeliveryCallback callback)
+{
+    send(topic, message, std::move(callback));
+}
+
+SendResult Producer::try_send(const std::string& topic, std::string_view message, DeliveryCallback callback)
+{
+    return send_for(topic, message, std::chrono::milliseconds(0), std::move(callback));
+}
+
+SendResult Producer::send_for(const std::string& topic, std::string_view message,
+                              std::chrono::milliseconds timeout, DeliveryCallback callback)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    rd_kafka_resp_err_t err = impl_->produce(topic, message.data(), message.size(), RD_KAFKA_MSG_F_COPY,
+                                             Buffer(), std::move(callback), deadline, false);
+    SendResult result;
+    result.success = (err == RD_KAFKA_RESP_ERR_NO_ERROR);
+    if (!result.success)
+        result.error = rd_kafka_err2str(err);
+    return result;
+}
+
+int Producer::fd() const
+{
+    return impl_->event_fd;
+}
+
+size_t Producer::drain()
+{
+    return impl_->drain(0);
+}
+
+int Producer::poll(int timeout_ms)
+{
+    return impl_->poll(timeout_ms);
 }
 
 void Producer::flush(int timeout_ms)
@@ -226,4 +1297,54 @@ void Producer::flush(int timeout_ms)
     impl_->flush(timeout_ms);
 }
 
+DeliveryMode Producer::delivery_mode() const
+{
+    return impl_->delivery.mode;
+}
+
+SpillStats Producer::spill_stats() const
+{
+    return impl_->spill_stats();
+}
+
+void Producer::init_transactions(int timeout_ms)
+{
+    Impl::check(rd_kafka_init_transactions(impl_->rk, timeout_ms), "Erro iniciando transações: ");
+}
+
+void Producer::begin_transaction()
+{
+    Impl::check(rd_kafka_begin_transaction(impl_->rk), "Erro iniciando a transação: ");
+}
+
+void Producer::send_offsets_to_transaction(const Consumer& consumer, int timeout_ms)
+{
+    impl_->send_offsets_to_transaction(consumer.handle(), timeout_ms);
+}
+
+void Producer::commit_transaction(int timeout_ms)
+{
+    impl_->commit_transaction(timeout_ms);
+}
+
+void Producer::abort_transaction(int timeout_ms)
+{
+    impl_->abort_transaction(timeout_ms);
+}
+
+std::vector<TopicCounters> Producer::topic_counters() const
+{
+    return impl_->topics->counters();
+}
+
+std::vector<TopicLatency> Producer::delivery_latency() const
+{
+    return impl_->topics->latencies();
+}
+
+ClientStats Producer::stats() const
+{
+    return impl_->statistics.snapshot();
+}
+
 } // namespace mykafka
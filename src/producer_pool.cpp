@@ -0,0 +1,155 @@
+#include "producer_pool.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <sys/stat.h>
+
+namespace mykafka {
+
+namespace {
+
+// Roda fn(i) para cada shard, cada um na sua thread, e espera todas
+template <typename Fn>
+void for_each_parallel(size_t count, Fn fn) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        threads.emplace_back([&fn, i]() { fn(i); });
+    for (auto& t : threads)
+        t.join();
+}
+
+// mistura o hash do tópico com a partição ou a chave
+size_t mix(size_t h, size_t v) {
+    return h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+} // namespace
+
+ProducerPool::ProducerPool(const ClientConfig& config, const PoolOptions& options,
+                           const DeliveryOptions& delivery)
+    : options_(options)
+{
+    if (options_.shards == 0)
+        throw std::invalid_argument("ProducerPool requer ao menos um shard");
+    // o mesmo id em todos os shards: cada init_transactions cercaria o anterior
+    if (!config.get("transactional.id").empty())
+        throw std::invalid_argument("ProducerPool não pode ser usado com transactional.id");
+
+    // um log de spill por shard: dois Producers no mesmo diretório disputariam os segmentos
+    const std::string spill_root = delivery.spill.directory;
+    if (!spill_root.empty() && mkdir(spill_root.c_str(), 0755) != 0 && errno != EEXIST)
+        throw std::runtime_error("Erro criando diretório de spill " + spill_root + ": " + std::strerror(errno));
+
+    // client.id distinto por shard: estatísticas e logs dos brokers separados
+    std::string base = config.get("client.id");
+    if (base.empty())
+        base = "mykafka-pool";
+
+    shards_.reserve(options_.shards);
+    for (size_t i = 0; i < options_.shards; ++i) {
+        ClientConfig shard_config = config;
+        shard_config.client_id(base + "-" + std::to_string(i));
+        DeliveryOptions shard_delivery = delivery;
+        if (!spill_root.empty())
+            shard_delivery.spill.directory = spill_root + "/shard-" + std::to_string(i);
+        shards_.push_back(std::make_unique<Producer>(shard_config, shard_delivery));
+    }
+}
+
+ProducerPool::~ProducerPool() {
+    // cada ~Producer espera até 3 s pelo flush: em paralelo, o pior caso não
+    // cresce com o número de shards
+    for_each_parallel(shards_.size(), [this](size_t i) { shards_[i].reset(); });
+}
+
+size_t ProducerPool::by_thread() const {
+    // um slot por thread, distribuído em round-robin na primeira vez que ela envia
+    static std::atomic<size_t> next_slot{0};
+    thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot % shards_.size();
+}
+
+size_t ProducerPool::by_topic(std::string_view topic) const {
+    if (options_.routing == PoolOptions::Routing::ThreadAffinity || shards_.size() == 1)
+        return by_thread();
+    return std::hash<std::string_view>()(topic) % shards_.size();
+}
+
+size_t ProducerPool::shard_of(const ProducerRecord& record) const {
+    if (options_.routing == PoolOptions::Routing::ThreadAffinity || shards_.size() == 1)
+        return by_thread();
+
+    size_t h = std::hash<std::string_view>()(record.topic);
+    if (record.partition >= 0)
+        return mix(h, static_cast<size_t>(record.partition)) % shards_.size();
+    // mesma chave → mesma partição pelo particionador → mesmo shard
+    if (record.key.data())
+        return mix(h, std::hash<std::string_view>()(record.key)) % shards_.size();
+    return by_topic(record.topic);
+}
+
+void ProducerPool::send(const std::string& topic, const std::string& message, Producer::DeliveryCallback callback) {
+    shards_[by_topic(topic)]->send(topic, message, std::move(callback));
+}
+
+void ProducerPool::send(const std::string& topic, const char* message, Producer::DeliveryCallback callback) {
+    shards_[by_topic(topic)]->send(topic, message, std::move(callback));
+}
+
+void ProducerPool::send(const std::string& topic, std::string&& message, Producer::DeliveryCallback callback) {
+    shards_[by_topic(topic)]->send(topic, std::move(message), std::move(callback));
+}
+
+void ProducerPool::send(const std::string& topic, Buffer buffer, Producer::DeliveryCallback callback) {
+    shards_[by_topic(topic)]->send(topic, std::move(buffer), std::move(callback));
+}
+
+void ProducerPool::send(const std::string& topic, std::string_view message, Producer::DeliveryCallback callback) {
+    shards_[by_topic(topic)]->send(topic, message, std::move(callback));
+}
+
+void ProducerPool::send(const ProducerRecord& record, Producer::DeliveryCallback callback) {
+    shards_[shard_of(record)]->send(record, std::move(callback));
+}
+
+void ProducerPool::send(const ProducerRecord& record, Buffer value, Producer::DeliveryCallback callback) {
+    shards_[shard_of(record)]->send(record, std::move(value), std::move(callback));
+}
+
+void ProducerPool::flush(int timeout_ms) {
+    for_each_parallel(shards_.size(), [this, timeout_ms](size_t i) { shards_[i]->flush(timeout_ms); });
+}
+
+std::vector<TopicCounters> ProducerPool::topic_counters() const {
+    std::map<std::string, TopicCounters> totals;
+    for (const auto& shard : shards_) {
+        for (const TopicCounters& c : shard->topic_counters()) {
+            auto it = totals.emplace(c.topic, TopicCounters{c.topic, 0, 0, 0}).first;
+            it->second.messages += c.messages;
+            it->second.bytes += c.bytes;
+            it->second.errors += c.errors;
+        }
+    }
+
+    std::vector<TopicCounters> result;
+    result.reserve(totals.size());
+    for (auto& kv : totals)
+        result.push_back(std::move(kv.second));
+    return result;
+}
+
+std::vector<ClientStats> ProducerPool::stats() const {
+    std::vector<ClientStats> result;
+    result.reserve(shards_.size());
+    for (const auto& shard : shards_)
+        result.push_back(shard->stats());
+    return result;
+}
+
+} // namespace mykafka
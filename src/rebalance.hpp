@@ -0,0 +1,39 @@
+#pragma once
+
+#include <librdkafka/rdkafka.h>
+#include <cstring>
+#include <iostream>
+
+namespace mykafka {
+
+// Aplicam o resultado de um rebalanceamento dentro do rebalance_cb, tanto no
+// protocolo eager (assign com a lista toda) quanto no cooperative (incremental).
+
+inline bool rebalance_is_cooperative(rd_kafka_t* rk) {
+    const char* protocol = rd_kafka_rebalance_protocol(rk);
+    return protocol && std::strcmp(protocol, "COOPERATIVE") == 0;
+}
+
+inline void assign_partitions(rd_kafka_t* rk, const rd_kafka_topic_partition_list_t* partitions) {
+    if (rebalance_is_cooperative(rk)) {
+        if (rd_kafka_error_t* error = rd_kafka_incremental_assign(rk, partitions)) {
+            std::cerr << "Erro no assign: " << rd_kafka_error_string(error) << std::endl;
+            rd_kafka_error_destroy(error);
+        }
+    } else {
+        rd_kafka_assign(rk, partitions);
+    }
+}
+
+inline void revoke_partitions(rd_kafka_t* rk, const rd_kafka_topic_partition_list_t* partitions) {
+    if (rebalance_is_cooperative(rk)) {
+        if (rd_kafka_error_t* error = rd_kafka_incremental_unassign(rk, partitions)) {
+            std::cerr << "Erro no unassign: " << rd_kafka_error_string(error) << std::endl;
+            rd_kafka_error_destroy(error);
+        }
+    } else {
+        rd_kafka_assign(rk, nullptr);
+    }
+}
+
+} // namespace mykafka
@@ -0,0 +1,322 @@
+#include "replay_reader.hpp"
+#include "util.hpp"
+#include <librdkafka/rdkafka.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace mykafka {
+
+namespace {
+
+void destroy_handle(rd_kafka_t* rk) {
+    rd_kafka_consumer_close(rk);
+    rd_kafka_destroy(rk);
+}
+
+using HandlePtr = std::unique_ptr<rd_kafka_t, void (*)(rd_kafka_t*)>;
+
+// Posição de leitura de uma partição numa thread
+struct Cursor {
+    const PartitionRange* range;
+    bool done = false;
+};
+
+} // namespace
+
+class ReplayReader::Impl {
+public:
+    ClientConfig config; // já com os ajustes de leitura
+    ReplayOptions options;
+    HandlePtr rk{nullptr, destroy_handle}; // consultas do resolve()
+
+    std::atomic<bool> running{false};        // o run() atual continua (cai com erro de handler)
+    std::atomic<bool> stop_requested{false}; // stop(): vale para sempre, nunca é zerado
+    std::atomic<uint64_t> processed{0};
+    std::atomic<size_t> partitions_left{0};
+
+    std::mutex error_mutex;
+    std::exception_ptr error; // primeira exceção de um handler
+
+    Impl(const ClientConfig& base, const ReplayOptions& opts) : config(base), options(opts) {
+        if (options.threads == 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (options.max_batch == 0)
+            options.max_batch = 1;
+
+        // sem subscribe não há grupo; o group.id só existe porque o assign exige.
+        // Nada é commitado nem guardado, então não interfere num grupo real.
+        if (config.get("group.id").empty())
+            config.group_id("mykafka-replay");
+        config.set("enable.auto.commit", "false", ClientConfig::Scope::Consumer)
+              .set("enable.auto.offset.store", "false", ClientConfig::Scope::Consumer)
+              .set("enable.partition.eof", "true", ClientConfig::Scope::Consumer)
+              .set("max.partition.fetch.bytes", std::to_string(options.partition_fetch_bytes),
+                   ClientConfig::Scope::Consumer)
+              .auto_offset_reset("earliest") // offset apagado pela retenção desde o resolve
+              .fetch_max_bytes(options.fetch_max_bytes)
+              .queued_max_messages_kbytes(options.queued_max_messages_kbytes);
+
+        rk = make_handle();
+    }
+
+    HandlePtr make_handle() const {
+        char errstr[512];
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        try {
+            config.apply(conf, ClientConfig::Scope::Consumer);
+        } catch (...) {
+            rd_kafka_conf_destroy(conf);
+            throw;
+        }
+        rd_kafka_t* handle = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
+        if (!handle)
+            throw std::runtime_error(std::string("Erro criando consumer de replay: ") + errstr);
+        return HandlePtr(handle, destroy_handle);
+    }
+
+    // offsets_for_times para um instante; -1 = nenhuma mensagem a partir dele
+    std::vector<int64_t> offsets_at(const std::string& topic, const std::vector<int32_t>& partitions,
+                                    int64_t timestamp_ms, int timeout_ms) {
+        rd_kafka_topic_partition_list_t* list =
+            rd_kafka_topic_partition_list_new(static_cast<int>(partitions.size()));
+        for (int32_t p : partitions)
+            rd_kafka_topic_partition_list_add(list, topic.c_str(), p)->offset = timestamp_ms;
+
+        rd_kafka_resp_err_t err = rd_kafka_offsets_for_times(rk.get(), list, timeout_ms);
+        std::string failed;
+        std::vector<int64_t> offsets;
+        for (int i = 0; err == RD_KAFKA_RESP_ERR_NO_ERROR && i < list->cnt; ++i) {
+            const rd_kafka_topic_partition_t& tp = list->elems[i];
+            if (tp.err != RD_KAFKA_RESP_ERR_NO_ERROR)
+                failed += std::string(failed.empty() ? "" : ", ") + tp.topic + "[" +
+                          std::to_string(tp.partition) + "]: " + rd_kafka_err2str(tp.err);
+            offsets.push_back(tp.offset);
+        }
+        rd_kafka_topic_partition_list_destroy(list);
+
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error(std::string("Erro no offsets_for_times: ") + rd_kafka_err2str(err));
+        if (!failed.empty())
+            throw std::runtime_error("Erro no offsets_for_times: " + failed);
+        return offsets;
+    }
+
+    int64_t high_watermark(const std::string& topic, int32_t partition, int timeout_ms) {
+        int64_t low = 0, high = 0;
+        rd_kafka_resp_err_t err =
+            rd_kafka_query_watermark_offsets(rk.get(), topic.c_str(), partition, &low, &high, timeout_ms);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error("Erro lendo fim de " + topic + "[" + std::to_string(partition) +
+                                     "]: " + rd_kafka_err2str(err));
+        return high;
+    }
+
+    std::vector<PartitionRange> resolve(const std::string& topic, std::vector<int32_t> partitions,
+                                        int64_t from_ms, int64_t to_ms, int timeout_ms) {
+        if (partitions.empty())
+            partitions = topic_partitions(rk.get(), topic, timeout_ms);
+        if (partitions.empty())
+            return {};
+
+        std::vector<int64_t> starts = offsets_at(topic, partitions, from_ms, timeout_ms);
+        std::vector<int64_t> ends = offsets_at(topic, partitions, to_ms, timeout_ms);
+
+        std::vector<PartitionRange> ranges;
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            // nada depois do instante: o limite é o fim atual da partição
+            int64_t high = -1;
+            if (starts[i] < 0 || ends[i] < 0)
+                high = high_watermark(topic, partitions[i], timeout_ms);
+
+            PartitionRange range;
+            range.topic = topic;
+            range.partition = partitions[i];
+            range.start_offset = starts[i] < 0 ? high : starts[i];
+            range.end_offset = std::max(range.start_offset, ends[i] < 0 ? high : ends[i]);
+            ranges.push_back(std::move(range));
+        }
+        return ranges;
+    }
+
+    uint64_t run(const std::vector<PartitionRange>& ranges, const Handler& handler) {
+        // intervalos vazios não precisam de leitura
+        std::vector<const PartitionRange*> pending;
+        for (const PartitionRange& r : ranges) {
+            if (r.end_offset > r.start_offset)
+                pending.push_back(&r);
+        }
+
+        processed = 0;
+        partitions_left = pending.size();
+        error = nullptr;
+        running = true;
+        if (pending.empty() || stop_requested.load())
+            return 0;
+
+        // maiores primeiro, cada um para a thread com menos mensagens até agora
+        std::sort(pending.begin(), pending.end(), [](const PartitionRange* a, const PartitionRange* b) {
+            return a->end_offset - a->start_offset > b->end_offset - b->start_offset;
+        });
+        size_t count = std::min(options.threads, pending.size());
+        std::vector<std::vector<const PartitionRange*>> shares(count);
+        std::vector<int64_t> load(count, 0);
+        for (const PartitionRange* r : pending) {
+            size_t t = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+            shares[t].push_back(r);
+            load[t] += r->end_offset - r->start_offset;
+        }
+
+        std::vector<std::thread> threads;
+        for (auto& share : shares) {
+            threads.emplace_back([this, &share, &handler]() {
+                try {
+                    read(share, handler);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    running = false;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        running = false;
+        if (error)
+            std::rethrow_exception(error);
+        return processed;
+    }
+
+    // Uma thread: handle próprio, assign das suas partições e leitura até
+    // todas chegarem ao end_offset
+    void read(const std::vector<const PartitionRange*>& share, const Handler& handler) {
+        HandlePtr handle = make_handle();
+
+        std::vector<Cursor> cursors;
+        rd_kafka_topic_partition_list_t* list =
+            rd_kafka_topic_partition_list_new(static_cast<int>(share.size()));
+        for (const PartitionRange* r : share) {
+            cursors.push_back({r});
+            rd_kafka_topic_partition_list_add(list, r->topic.c_str(), r->partition)->offset = r->start_offset;
+        }
+        rd_kafka_resp_err_t err = rd_kafka_assign(handle.get(), list);
+        rd_kafka_topic_partition_list_destroy(list);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error(std::string("Erro no assign do replay: ") + rd_kafka_err2str(err));
+
+        std::unique_ptr<rd_kafka_queue_t, void (*)(rd_kafka_queue_t*)> queue(
+            rd_kafka_queue_get_consumer(handle.get()), rd_kafka_queue_destroy);
+        std::vector<rd_kafka_message_t*> raw(options.max_batch);
+        size_t left = cursors.size();
+        Cursor* last = nullptr; // lotes costumam vir em sequência da mesma partição
+
+        auto find = [&](const rd_kafka_message_t* msg) -> Cursor* {
+            if (last && last->range->partition == msg->partition &&
+                last->range->topic == rd_kafka_topic_name(msg->rkt))
+                return last;
+            for (Cursor& c : cursors) {
+                if (c.range->partition == msg->partition && c.range->topic == rd_kafka_topic_name(msg->rkt))
+                    return last = &c;
+            }
+            return nullptr;
+        };
+
+        // chegou ao fim: para de buscar; o que já veio na pré-busca é descartado
+        auto finish = [&](Cursor* c) {
+            c->done = true;
+            --left;
+            partitions_left.fetch_sub(1, std::memory_order_relaxed);
+            rd_kafka_topic_partition_list_t* tp = rd_kafka_topic_partition_list_new(1);
+            rd_kafka_topic_partition_list_add(tp, c->range->topic.c_str(), c->range->partition);
+            rd_kafka_pause_partitions(handle.get(), tp);
+            rd_kafka_topic_partition_list_destroy(tp);
+        };
+
+        // uma mensagem; ela é sempre liberada, mesmo se o handler lançar
+        auto handle_message = [&](rd_kafka_message_t* msg) {
+            Cursor* c = msg->rkt ? find(msg) : nullptr;
+            if (!c || c->done) {
+                // partição já terminada, ou erro sem partição
+            } else if (msg->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+                // EOF traz a próxima posição: mensagens apagadas (compactação,
+                // marcadores de transação) podem pular o end_offset - 1
+                if (msg->offset >= c->range->end_offset)
+                    finish(c);
+            } else if (msg->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                std::cerr << "Erro no replay: " << rd_kafka_message_errstr(msg) << std::endl;
+            } else if (msg->offset >= c->range->end_offset) {
+                finish(c);
+            } else {
+                int64_t offset = msg->offset;
+                try {
+                    handler(MessageView(msg, &msg)); // 'msg' vira nulo se o handler a reter
+                } catch (...) {
+                    if (msg)
+                        rd_kafka_message_destroy(msg);
+                    throw;
+                }
+                processed.fetch_add(1, std::memory_order_relaxed);
+                if (offset + 1 >= c->range->end_offset)
+                    finish(c);
+            }
+            if (msg)
+                rd_kafka_message_destroy(msg);
+        };
+
+        while (left > 0 && running.load(std::memory_order_relaxed) &&
+               !stop_requested.load(std::memory_order_relaxed)) {
+            ssize_t n = rd_kafka_consume_batch_queue(queue.get(), 100, raw.data(), raw.size());
+            if (n < 0) {
+                std::cerr << "Erro ao consumir lote do replay: "
+                          << rd_kafka_err2str(rd_kafka_last_error()) << std::endl;
+                continue;
+            }
+            ssize_t i = 0;
+            try {
+                for (; i < n; ++i)
+                    handle_message(raw[i]);
+            } catch (...) {
+                for (++i; i < n; ++i)
+                    rd_kafka_message_destroy(raw[i]);
+                throw;
+            }
+        }
+    }
+};
+
+ReplayReader::ReplayReader(const ClientConfig& config, const ReplayOptions& options)
+    : impl_(std::make_unique<Impl>(config, options))
+{
+}
+
+ReplayReader::~ReplayReader() = default;
+
+std::vector<PartitionRange> ReplayReader::resolve(const std::string& topic,
+                                                  const std::vector<int32_t>& partitions,
+                                                  int64_t from_ms, int64_t to_ms, int timeout_ms) {
+    return impl_->resolve(topic, partitions, from_ms, to_ms, timeout_ms);
+}
+
+uint64_t ReplayReader::run(const std::vector<PartitionRange>& ranges, Handler handler) {
+    return impl_->run(ranges, handler);
+}
+
+void ReplayReader::stop() {
+    impl_->stop_requested = true;
+}
+
+uint64_t ReplayReader::processed() const {
+    return impl_->processed.load(std::memory_order_relaxed);
+}
+
+size_t ReplayReader::partitions_left() const {
+    return impl_->partitions_left.load(std::memory_order_relaxed);
+}
+
+} // namespace mykafka
@@ -0,0 +1,360 @@
+#include "spill_log.hpp"
+#include "crc32c.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mykafka {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'K', 'S', 'P', 'I', 'L', 'L', '1'};
+constexpr size_t kHeaderSize = 16;      // magic + reservado
+constexpr size_t kRecordHeaderSize = 8; // tamanho + crc
+
+// Escrita e leitura sequenciais dos campos do corpo (ordem de bytes da máquina:
+// o log só é lido pela mesma máquina)
+class Writer {
+public:
+    explicit Writer(char* p) : p_(p) {}
+    template <typename T> void put(T v) { std::memcpy(p_, &v, sizeof(T)); p_ += sizeof(T); }
+    void bytes(std::string_view s) { if (!s.empty()) std::memcpy(p_, s.data(), s.size()); p_ += s.size(); }
+private:
+    char* p_;
+};
+
+class Reader {
+public:
+    Reader(const char* p, size_t size) : p_(p), end_(p + size) {}
+    template <typename T> T get() {
+        need(sizeof(T));
+        T v;
+        std::memcpy(&v, p_, sizeof(T));
+        p_ += sizeof(T);
+        return v;
+    }
+    std::string_view bytes(size_t n) {
+        need(n);
+        std::string_view s(p_, n);
+        p_ += n;
+        return s;
+    }
+private:
+    void need(size_t n) {
+        if (static_cast<size_t>(end_ - p_) < n)
+            throw std::runtime_error("Registro de spill truncado");
+    }
+    const char* p_;
+    const char* end_;
+};
+
+size_t body_size(const ProducerRecord& record, std::string_view value) {
+    size_t size = 2 + record.topic.size() + 4 + 8 + 4 + record.key.size() + 4 + value.size() + 2;
+    for (const Header& h : record.headers)
+        size += 2 + h.name.size() + 4 + h.value.size();
+    return size;
+}
+
+} // namespace
+
+struct SpillLog::Segment {
+    uint64_t seq = 0;
+    std::string path;
+    int fd = -1;
+    char* base = nullptr;
+    size_t size = 0;
+    size_t write_pos = kHeaderSize;
+    size_t read_pos = kHeaderSize;
+    uint64_t written = 0;
+    uint64_t read = 0;
+    uint64_t delivered = 0;
+    bool sealed = false; // não recebe mais registros
+
+    ~Segment() {
+        if (base)
+            munmap(base, size);
+        if (fd >= 0)
+            close(fd);
+    }
+};
+
+SpillLog::SpillLog(const std::string& directory, size_t segment_bytes)
+    : directory_(directory), segment_bytes_(std::max(segment_bytes, size_t(4096)))
+{
+    if (mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+        throw std::runtime_error(errno_text("Erro criando diretório de spill", directory_));
+    recover();
+}
+
+SpillLog::~SpillLog() = default; // os segmentos ficam no disco para a próxima vez
+
+SpillLog::Segment* SpillLog::open_segment(uint64_t seq, size_t size, bool create) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "/spill-%020llu.log", static_cast<unsigned long long>(seq));
+
+    auto segment = std::make_unique<Segment>();
+    segment->seq = seq;
+    segment->path = directory_ + name;
+
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT | O_EXCL : 0), 0644);
+    if (segment->fd < 0)
+        throw std::runtime_error(errno_text("Erro abrindo segmento de spill", segment->path));
+
+    if (create) {
+        // reserva os blocos agora: disco cheio vira erro aqui, e não SIGBUS no memcpy
+        int err = posix_fallocate(segment->fd, 0, static_cast<off_t>(size));
+        if (err != 0) {
+            errno = err;
+            std::string what = errno_text("Erro reservando segmento de spill", segment->path);
+            unlink(segment->path.c_str());
+            throw std::runtime_error(what);
+        }
+    } else {
+        struct stat st;
+        if (fstat(segment->fd, &st) != 0)
+            throw std::runtime_error(errno_text("Erro lendo segmento de spill", segment->path));
+        size = static_cast<size_t>(st.st_size);
+        if (size < kHeaderSize)
+            return nullptr;
+    }
+    segment->size = size;
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (base == MAP_FAILED)
+        throw std::runtime_error(errno_text("Erro mapeando segmento de spill", segment->path));
+    segment->base = static_cast<char*>(base);
+
+    if (create)
+        std::memcpy(segment->base, kMagic, sizeof(kMagic));
+    else if (std::memcmp(segment->base, kMagic, sizeof(kMagic)) != 0)
+        return nullptr;
+
+    segments_.push_back(std::move(segment));
+    return segments_.back().get();
+}
+
+void SpillLog::recover() {
+    std::vector<uint64_t> seqs;
+    if (DIR* dir = opendir(directory_.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            unsigned long long seq;
+            char tail;
+            if (std::sscanf(entry->d_name, "spill-%20llu.lo%c", &seq, &tail) == 2 && tail == 'g')
+                seqs.push_back(seq);
+        }
+        closedir(dir);
+    }
+    std::sort(seqs.begin(), seqs.end());
+
+    for (uint64_t seq : seqs) {
+        next_seq_ = seq + 1;
+        Segment* segment = open_segment(seq, 0, false);
+        if (!segment) {
+            std::cerr << "Segmento de spill inválido ignorado: " << directory_ << "/spill-" << seq << ".log" << std::endl;
+            continue;
+        }
+
+        // percorre os registros até o fim (tamanho zero) ou o primeiro que não confere
+        size_t pos = kHeaderSize;
+        while (pos + kRecordHeaderSize <= segment->size) {
+            uint32_t len, crc;
+            std::memcpy(&len, segment->base + pos, 4);
+            std::memcpy(&crc, segment->base + pos + 4, 4);
+            if (len == 0)
+                break;
+            if (len > segment->size - pos - kRecordHeaderSize ||
+                crc32c(segment->base + pos + kRecordHeaderSize, len) != crc) {
+                std::cerr << "Registro corrompido em " << segment->path << " (posição " << pos
+                          << "): o resto do segmento é descartado" << std::endl;
+                break;
+            }
+            pos += kRecordHeaderSize + len;
+            ++segment->written;
+        }
+        segment->write_pos = pos;
+        segment->sealed = true;
+
+        pending_ += segment->written;
+        recovered_ += segment->written;
+        if (segment->written == 0)
+            release(segment);
+    }
+    if (pending_ > 0)
+        active_ = true;
+}
+
+char* SpillLog::reserve(size_t total) {
+    Segment* segment = segments_.empty() ? nullptr : segments_.back().get();
+    if (!segment || segment->sealed || segment->write_pos + total > segment->size) {
+        if (segment && !segment->sealed) {
+            segment->sealed = true;
+            msync(segment->base, segment->size, MS_ASYNC);
+            release(segment);
+        }
+        segment = open_segment(next_seq_++, std::max(segment_bytes_, kHeaderSize + total), true);
+    }
+
+    char* p = segment->base + segment->write_pos;
+    segment->write_pos += total;
+    ++segment->written;
+    ++pending_;
+    active_ = true;
+    return p;
+}
+
+void SpillLog::append(const ProducerRecord& record, std::string_view value, int64_t timestamp_ms) {
+    size_t body = body_size(record, value);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    char* p = reserve(kRecordHeaderSize + body);
+    Writer w(p + kRecordHeaderSize);
+    w.put<uint16_t>(static_cast<uint16_t>(record.topic.size()));
+    w.bytes(record.topic);
+    w.put<int32_t>(record.partition);
+    w.put<int64_t>(timestamp_ms);
+    w.put<int32_t>(record.key.data() ? static_cast<int32_t>(record.key.size()) : -1);
+    w.bytes(record.key);
+    w.put<uint32_t>(static_cast<uint32_t>(value.size()));
+    w.bytes(value);
+    w.put<uint16_t>(static_cast<uint16_t>(record.headers.size()));
+    for (const Header& h : record.headers) {
+        w.put<uint16_t>(static_cast<uint16_t>(h.name.size()));
+        w.bytes(h.name);
+        w.put<int32_t>(h.value.data() ? static_cast<int32_t>(h.value.size()) : -1);
+        w.bytes(h.value);
+    }
+
+    // o tamanho por último: até aqui o registro não existe para a leitura
+    uint32_t crc = crc32c(p + kRecordHeaderSize, body);
+    uint32_t len = static_cast<uint32_t>(body);
+    std::memcpy(p + 4, &crc, 4);
+    std::memcpy(p, &len, 4);
+}
+
+SpillLog::Segment* SpillLog::peek(ProducerRecord& record, uint64_t& position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& s : segments_) {
+        Segment* segment = s.get();
+        if (segment->read == segment->written)
+            continue;
+
+        const char* p = segment->base + segment->read_pos;
+        uint32_t len;
+        std::memcpy(&len, p, 4);
+        Reader r(p + kRecordHeaderSize, len);
+
+        record.topic.assign(r.bytes(r.get<uint16_t>()));
+        record.partition = r.get<int32_t>();
+        record.timestamp_ms = r.get<int64_t>();
+        int32_t key_len = r.get<int32_t>();
+        record.key = key_len < 0 ? std::string_view() : r.bytes(static_cast<size_t>(key_len));
+        record.value = r.bytes(r.get<uint32_t>());
+        record.headers.resize(r.get<uint16_t>());
+        for (Header& h : record.headers) {
+            h.name = r.bytes(r.get<uint16_t>());
+            int32_t value_len = r.get<int32_t>();
+            h.value = value_len < 0 ? std::string_view() : r.bytes(static_cast<size_t>(value_len));
+        }
+
+        peeked_size_ = kRecordHeaderSize + len;
+        position = segment->read_pos;
+        return segment;
+    }
+    return nullptr;
+}
+
+void SpillLog::advance(Segment* segment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    segment->read_pos += peeked_size_;
+    ++segment->read;
+    --pending_;
+    release(segment);
+}
+
+void SpillLog::delivered(Segment* segment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++segment->delivered;
+    release(segment);
+}
+
+void SpillLog::requeue(Segment* segment, uint64_t position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // o original só é apagado depois do delivered abaixo: a origem ainda está mapeada
+    const char* src = segment->base + position;
+    uint32_t len;
+    std::memcpy(&len, src, 4);
+    char* p = reserve(kRecordHeaderSize + len);
+    std::memcpy(p + 4, src + 4, 4 + len);
+    std::memcpy(p, &len, 4);
+
+    ++segment->delivered;
+    release(segment);
+}
+
+void SpillLog::dropped(Segment* segment, const std::string& error) {
+    std::cerr << "Mensagem do spill descartada (" << segment->path << "): " << error << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++lost_;
+    ++segment->delivered;
+    release(segment);
+}
+
+bool SpillLog::drained() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ > 0)
+        return false;
+    // fecha o segmento atual para ele poder ser apagado após as entregas
+    if (!segments_.empty() && !segments_.back()->sealed) {
+        Segment* segment = segments_.back().get();
+        segment->sealed = true;
+        release(segment);
+    }
+    active_ = false;
+    return true;
+}
+
+bool SpillLog::active() const {
+    return active_.load(std::memory_order_acquire);
+}
+
+uint64_t SpillLog::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+uint64_t SpillLog::recovered() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recovered_;
+}
+
+uint64_t SpillLog::lost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lost_;
+}
+
+size_t SpillLog::segments() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_.size();
+}
+
+void SpillLog::release(Segment* segment) {
+    if (!segment->sealed || segment->read < segment->written || segment->delivered < segment->written)
+        return;
+    unlink(segment->path.c_str());
+    auto it = std::find_if(segments_.begin(), segments_.end(),
+                           [segment](const std::unique_ptr<Segment>& s) { return s.get() == segment; });
+    if (it != segments_.end())
+        segments_.erase(it);
+}
+
+} // namespace mykafka
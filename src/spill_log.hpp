@@ -0,0 +1,83 @@
+#pragma once
+
+#include "producer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mykafka {
+
+// Log em disco, segmentado e mapeado em memória (mmap), para onde o Producer
+// transborda mensagens quando a fila da librdkafka passa da marca. Estritamente
+// FIFO: um único escritor lógico (append, sob mutex) e um único leitor (peek/advance).
+//
+// Segmento: arquivo spill-<seq>.log, pré-alocado com zeros, com um cabeçalho
+// fixo e registros [tamanho u32][crc32c u32][corpo]. O tamanho é escrito por
+// último: zero marca o fim, e um registro pela metade (queda do processo) não
+// passa no CRC. O segmento é apagado quando todas as suas mensagens tiveram
+// relatório de entrega; o que sobrar no diretório é recuperado na próxima vez.
+class SpillLog {
+public:
+    struct Segment;
+
+    SpillLog(const std::string& directory, size_t segment_bytes);
+    ~SpillLog();
+
+    SpillLog(const SpillLog&) = delete;
+    SpillLog& operator=(const SpillLog&) = delete;
+
+    // Grava o registro com 'value' e 'timestamp_ms' no lugar dos do record
+    // (chave com data() == nullptr: sem chave). Erros de E/S viram std::runtime_error.
+    void append(const ProducerRecord& record, std::string_view value, int64_t timestamp_ms);
+
+    // Próximo registro, sem consumir: as views apontam para o mmap e valem até
+    // o advance(). 'position' identifica o registro para o requeue().
+    // Retorna nullptr se não houver nada.
+    Segment* peek(ProducerRecord& record, uint64_t& position);
+    // Consome o registro do último peek, que é do 'segment' devolvido por ele
+    void advance(Segment* segment);
+    // Um registro do segmento teve relatório de entrega (sucesso ou não). Pode
+    // vir antes do advance() desse registro.
+    void delivered(Segment* segment);
+    // O reenvio do registro em 'position' falhou: uma cópia vai para o fim do
+    // log e o original conta como entregue
+    void requeue(Segment* segment, uint64_t position);
+    // O registro foi recusado de vez e não há a quem avisar: conta como
+    // entregue, vai para o stderr e para o lost()
+    void dropped(Segment* segment, const std::string& error);
+
+    // Nada pendente de leitura; se estiver vazio também encerra o modo de transbordo
+    bool drained();
+    // Em modo de transbordo: desde o primeiro append até o log esvaziar
+    bool active() const;
+
+    uint64_t pending() const;   // registros ainda não lidos
+    uint64_t recovered() const; // registros encontrados no disco ao abrir
+    uint64_t lost() const;      // descartados pelo dropped()
+    size_t segments() const;
+
+private:
+    Segment* open_segment(uint64_t seq, size_t size, bool create);
+    void recover();
+    // apaga o segmento se não precisa mais dele: fechado, todo lido e todo entregue
+    void release(Segment* segment);
+    // espaço para 'total' bytes no fim do log, abrindo outro segmento se preciso
+    char* reserve(size_t total);
+
+    std::string directory_;
+    size_t segment_bytes_;
+
+    mutable std::mutex mutex_;
+    std::deque<std::unique_ptr<Segment>> segments_; // o primeiro é lido, o último é escrito
+    uint64_t next_seq_ = 0;
+    uint64_t pending_ = 0;
+    uint64_t recovered_ = 0;
+    uint64_t lost_ = 0;
+    std::atomic<bool> active_{false}; // lido sem lock a cada send
+    size_t peeked_size_ = 0; // tamanho total do registro do último peek
+};
+
+} // namespace mykafka
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace mykafka {
+
+// Fila circular limitada, sem lock, para exatamente um produtor e um consumidor.
+// A capacidade é arredondada para a próxima potência de 2.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        mask_ = size - 1;
+        slots_ = std::make_unique<T[]>(size);
+    }
+
+    // só o produtor
+    bool try_push(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false; // cheia
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // só o consumidor
+    bool try_pop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false; // vazia
+        }
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    // produtor e consumidor em linhas de cache separadas
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0; // visão do produtor
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0; // visão do consumidor
+    alignas(64) size_t mask_ = 0;
+    std::unique_ptr<T[]> slots_;
+};
+
+} // namespace mykafka
@@ -0,0 +1,377 @@
+#include "stats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace mykafka {
+
+namespace {
+
+// Parser JSON mínimo, suficiente para o documento de estatísticas da librdkafka
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    double number = 0;
+    std::string str;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(std::string_view key) const {
+        for (const auto& m : members) {
+            if (m.first == key)
+                return &m.second;
+        }
+        return nullptr;
+    }
+
+    int64_t integer(std::string_view key, int64_t fallback = 0) const {
+        const JsonValue* v = find(key);
+        return v && v->type == Type::Number ? static_cast<int64_t>(v->number) : fallback;
+    }
+
+    std::string text(std::string_view key) const {
+        const JsonValue* v = find(key);
+        return v && v->type == Type::String ? v->str : std::string();
+    }
+
+    // campo de uma janela (rtt, throttle, batchsize...): ex. window("rtt", "p99")
+    int64_t window(std::string_view key, std::string_view field) const {
+        const JsonValue* v = find(key);
+        return v ? v->integer(field) : 0;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : s_(text) {}
+
+    JsonValue parse() {
+        JsonValue v = value();
+        skip_ws();
+        if (pos_ != s_.size())
+            fail("conteúdo extra");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) {
+        throw std::runtime_error(std::string("JSON de estatísticas inválido: ") + what +
+                                 " (posição " + std::to_string(pos_) + ")");
+    }
+
+    void skip_ws() {
+        while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\n' || s_[pos_] == '\r' || s_[pos_] == '\t'))
+            ++pos_;
+    }
+
+    char peek() {
+        skip_ws();
+        if (pos_ >= s_.size())
+            fail("fim inesperado");
+        return s_[pos_];
+    }
+
+    void expect(char c) {
+        if (peek() != c)
+            fail("caractere inesperado");
+        ++pos_;
+    }
+
+    bool consume(std::string_view word) {
+        if (s_.substr(pos_, word.size()) != word)
+            return false;
+        pos_ += word.size();
+        return true;
+    }
+
+    JsonValue value() {
+        JsonValue v;
+        char c = peek();
+        if (c == '{') {
+            v.type = JsonValue::Type::Object;
+            ++pos_;
+            if (peek() == '}') { ++pos_; return v; }
+            for (;;) {
+                std::string key = string();
+                expect(':');
+                v.members.emplace_back(std::move(key), value());
+                if (peek() == ',') { ++pos_; continue; }
+                expect('}');
+                return v;
+            }
+        }
+        if (c == '[') {
+            v.type = JsonValue::Type::Array;
+            ++pos_;
+            if (peek() == ']') { ++pos_; return v; }
+            for (;;) {
+                v.items.push_back(value());
+                if (peek() == ',') { ++pos_; continue; }
+                expect(']');
+                return v;
+            }
+        }
+        if (c == '"') {
+            v.type = JsonValue::Type::String;
+            v.str = string();
+            return v;
+        }
+        if (consume("true"))  { v.type = JsonValue::Type::Bool; v.number = 1; return v; }
+        if (consume("false")) { v.type = JsonValue::Type::Bool; return v; }
+        if (consume("null"))  { return v; }
+
+        // número
+        const std::string token(s_.substr(pos_, std::min<size_t>(64, s_.size() - pos_)));
+        char* end = nullptr;
+        v.number = std::strtod(token.c_str(), &end);
+        if (end == token.c_str())
+            fail("valor inválido");
+        v.type = JsonValue::Type::Number;
+        pos_ += static_cast<size_t>(end - token.c_str());
+        return v;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string out;
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            char c = s_[pos_++];
+            if (c == '\\' && pos_ < s_.size()) {
+                char e = s_[pos_++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': // nomes de brokers/tópicos são ASCII; mantém o escape literal
+                        out += "\\u";
+                        break;
+                    default: out += e; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos_ >= s_.size())
+            fail("string sem fim");
+        ++pos_;
+        return out;
+    }
+
+    std::string_view s_;
+    size_t pos_ = 0;
+};
+
+// Escapa valores de label conforme o formato texto do Prometheus
+std::string label(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"')
+            out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+class PromWriter {
+public:
+    PromWriter(std::ostringstream& out, const std::string& prefix, const std::string& client)
+        : out_(out), prefix_(prefix), client_(label(client)) {}
+
+    void header(const char* name, const char* help, const char* type = "gauge") {
+        out_ << "# HELP " << prefix_ << '_' << name << ' ' << help << '\n'
+             << "# TYPE " << prefix_ << '_' << name << ' ' << type << '\n';
+    }
+
+    // 'labels' já vem no formato k="v",k2="v2" (ou vazio)
+    void sample(const char* name, const std::string& labels, double value) {
+        out_ << prefix_ << '_' << name << "{client=\"" << client_ << '"';
+        if (!labels.empty())
+            out_ << ',' << labels;
+        out_ << "} ";
+        // contadores inteiros saem exatos (o ostream usaria notação científica)
+        if (value == static_cast<double>(static_cast<int64_t>(value)))
+            out_ << static_cast<int64_t>(value);
+        else
+            out_ << value;
+        out_ << '\n';
+    }
+
+private:
+    std::ostringstream& out_;
+    const std::string& prefix_;
+    std::string client_;
+};
+
+} // namespace
+
+ClientStats parse_stats(std::string_view json) {
+    JsonValue root = JsonParser(json).parse();
+
+    ClientStats st;
+    st.name         = root.text("name");
+    st.type         = root.text("type");
+    st.ts_us        = root.integer("ts");
+    st.replyq       = root.integer("replyq");
+    st.msg_cnt      = root.integer("msg_cnt");
+    st.msg_size     = root.integer("msg_size");
+    st.msg_max      = root.integer("msg_max");
+    st.msg_size_max = root.integer("msg_size_max");
+    st.tx           = root.integer("tx");
+    st.rx           = root.integer("rx");
+    st.txmsgs       = root.integer("txmsgs");
+    st.rxmsgs       = root.integer("rxmsgs");
+
+    if (const JsonValue* brokers = root.find("brokers")) {
+        for (const auto& kv : brokers->members) {
+            const JsonValue& b = kv.second;
+            BrokerStats bs;
+            bs.name            = b.text("name");
+            bs.nodeid          = static_cast<int32_t>(b.integer("nodeid", -1));
+            bs.state           = b.text("state");
+            bs.outbuf_cnt      = b.integer("outbuf_cnt");
+            bs.waitresp_cnt    = b.integer("waitresp_cnt");
+            bs.tx              = b.integer("tx");
+            bs.rx              = b.integer("rx");
+            bs.rtt_avg_us      = b.window("rtt", "avg");
+            bs.rtt_p99_us      = b.window("rtt", "p99");
+            bs.throttle_avg_ms = b.window("throttle", "avg");
+            bs.throttle_max_ms = b.window("throttle", "max");
+            st.brokers.push_back(std::move(bs));
+        }
+    }
+
+    if (const JsonValue* topics = root.find("topics")) {
+        for (const auto& kv : topics->members) {
+            const JsonValue& t = kv.second;
+            TopicStats ts;
+            ts.topic         = t.text("topic");
+            ts.batchsize_avg = t.window("batchsize", "avg");
+            ts.batchsize_p99 = t.window("batchsize", "p99");
+            ts.batchcnt_avg  = t.window("batchcnt", "avg");
+            ts.batchcnt_p99  = t.window("batchcnt", "p99");
+            st.topics.push_back(ts);
+
+            const JsonValue* partitions = t.find("partitions");
+            if (!partitions)
+                continue;
+            for (const auto& pkv : partitions->members) {
+                const JsonValue& p = pkv.second;
+                PartitionStats ps;
+                ps.topic     = ts.topic;
+                ps.partition = static_cast<int32_t>(p.integer("partition", -1));
+                if (ps.partition < 0)
+                    continue; // partição interna "UA" (ainda não atribuída)
+                ps.leader           = static_cast<int32_t>(p.integer("leader", -1));
+                ps.msgq_cnt         = p.integer("msgq_cnt");
+                ps.xmit_msgq_cnt    = p.integer("xmit_msgq_cnt");
+                ps.fetchq_cnt       = p.integer("fetchq_cnt");
+                ps.fetchq_size      = p.integer("fetchq_size");
+                ps.hi_offset        = p.integer("hi_offset", -1);
+                ps.committed_offset = p.integer("committed_offset", -1);
+                ps.consumer_lag     = p.integer("consumer_lag", -1);
+                st.partitions.push_back(std::move(ps));
+            }
+        }
+    }
+
+    return st;
+}
+
+std::string to_prometheus(const ClientStats& st, const std::string& prefix) {
+    std::ostringstream out;
+    if (!st.valid())
+        return "";
+
+    PromWriter w(out, prefix, st.name);
+
+    // --- cliente ---
+    w.header("queue_messages", "Mensagens nas filas internas da librdkafka (msg_cnt)");
+    w.sample("queue_messages", "", double(st.msg_cnt));
+    w.header("queue_bytes", "Bytes nas filas internas da librdkafka (msg_size)");
+    w.sample("queue_bytes", "", double(st.msg_size));
+    w.header("queue_max_messages", "Limite de mensagens nas filas internas (msg_max)");
+    w.sample("queue_max_messages", "", double(st.msg_max));
+    w.header("queue_max_bytes", "Limite de bytes nas filas internas (msg_size_max)");
+    w.sample("queue_max_bytes", "", double(st.msg_size_max));
+    w.header("reply_queue", "Eventos aguardando poll (replyq)");
+    w.sample("reply_queue", "", double(st.replyq));
+    w.header("tx_messages_total", "Mensagens enviadas aos brokers", "counter");
+    w.sample("tx_messages_total", "", double(st.txmsgs));
+    w.header("rx_messages_total", "Mensagens recebidas dos brokers", "counter");
+    w.sample("rx_messages_total", "", double(st.rxmsgs));
+
+    // --- brokers ---
+    if (!st.brokers.empty()) {
+        auto broker_label = [](const BrokerStats& b) {
+            return "broker=\"" + label(b.name) + "\",nodeid=\"" + std::to_string(b.nodeid) + '"';
+        };
+        w.header("broker_rtt_avg_seconds", "RTT médio com o broker");
+        for (const auto& b : st.brokers)
+            w.sample("broker_rtt_avg_seconds", broker_label(b), b.rtt_avg_us / 1e6);
+        w.header("broker_rtt_p99_seconds", "RTT p99 com o broker");
+        for (const auto& b : st.brokers)
+            w.sample("broker_rtt_p99_seconds", broker_label(b), b.rtt_p99_us / 1e6);
+        w.header("broker_throttle_avg_seconds", "Throttle médio imposto pelo broker");
+        for (const auto& b : st.brokers)
+            w.sample("broker_throttle_avg_seconds", broker_label(b), b.throttle_avg_ms / 1e3);
+        w.header("broker_throttle_max_seconds", "Maior throttle imposto pelo broker na janela");
+        for (const auto& b : st.brokers)
+            w.sample("broker_throttle_max_seconds", broker_label(b), b.throttle_max_ms / 1e3);
+        w.header("broker_outbuf_requests", "Requisições aguardando envio ao broker");
+        for (const auto& b : st.brokers)
+            w.sample("broker_outbuf_requests", broker_label(b), double(b.outbuf_cnt));
+        w.header("broker_inflight_requests", "Requisições aguardando resposta do broker");
+        for (const auto& b : st.brokers)
+            w.sample("broker_inflight_requests", broker_label(b), double(b.waitresp_cnt));
+        w.header("broker_up", "1 se a conexão com o broker está UP");
+        for (const auto& b : st.brokers)
+            w.sample("broker_up", broker_label(b), b.state == "UP" ? 1.0 : 0.0);
+    }
+
+    // --- tópicos ---
+    if (!st.topics.empty()) {
+        auto topic_label = [](const TopicStats& t) { return "topic=\"" + label(t.topic) + '"'; };
+        w.header("topic_batch_bytes_avg", "Tamanho médio dos lotes enviados");
+        for (const auto& t : st.topics)
+            w.sample("topic_batch_bytes_avg", topic_label(t), double(t.batchsize_avg));
+        w.header("topic_batch_messages_avg", "Mensagens por lote enviado (média)");
+        for (const auto& t : st.topics)
+            w.sample("topic_batch_messages_avg", topic_label(t), double(t.batchcnt_avg));
+        w.header("topic_batch_messages_p99", "Mensagens por lote enviado (p99)");
+        for (const auto& t : st.topics)
+            w.sample("topic_batch_messages_p99", topic_label(t), double(t.batchcnt_p99));
+    }
+
+    // --- partições ---
+    if (!st.partitions.empty()) {
+        auto part_label = [](const PartitionStats& p) {
+            return "topic=\"" + label(p.topic) + "\",partition=\"" + std::to_string(p.partition) + '"';
+        };
+        w.header("partition_queue_messages", "Mensagens aguardando envio na partição");
+        for (const auto& p : st.partitions)
+            w.sample("partition_queue_messages", part_label(p), double(p.msgq_cnt + p.xmit_msgq_cnt));
+        w.header("partition_fetch_queue_messages", "Mensagens pré-buscadas na partição");
+        for (const auto& p : st.partitions)
+            w.sample("partition_fetch_queue_messages", part_label(p), double(p.fetchq_cnt));
+        w.header("partition_fetch_queue_bytes", "Bytes pré-buscados na partição");
+        for (const auto& p : st.partitions)
+            w.sample("partition_fetch_queue_bytes", part_label(p), double(p.fetchq_size));
+        w.header("partition_consumer_lag", "Lag do consumer na partição (-1 se desconhecido)");
+        for (const auto& p : st.partitions)
+            w.sample("partition_consumer_lag", part_label(p), double(p.consumer_lag));
+    }
+
+    return out.str();
+}
+
+} // namespace mykafka
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "stats.hpp"
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+
+namespace mykafka {
+
+// Guarda o último JSON de estatísticas recebido. O stats_cb da librdkafka só
+// copia o texto (uma vez por statistics.interval.ms); a conversão acontece sob
+// demanda em snapshot(), na thread de quem pede, longe do envio e do consumo.
+class StatsCollector {
+public:
+    void store(const char* json, size_t len) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        raw_.assign(json, len);
+        ++generation_;
+    }
+
+    ClientStats snapshot() {
+        std::string raw;
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation_ == parsed_generation_)
+                return parsed_;
+            raw = raw_;
+            generation = generation_;
+        }
+
+        ClientStats parsed;
+        try {
+            parsed = parse_stats(raw);
+        } catch (const std::exception&) {
+            // JSON inesperado: mantém o último snapshot válido
+            std::lock_guard<std::mutex> lock(mutex_);
+            return parsed_;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation > parsed_generation_) {
+            parsed_ = std::move(parsed);
+            parsed_generation_ = generation;
+        }
+        return parsed_;
+    }
+
+    std::string raw_json() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return raw_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::string raw_;
+    uint64_t generation_ = 0;
+    ClientStats parsed_;
+    uint64_t parsed_generation_ = 0;
+};
+
+} // namespace mykafka
@@ -0,0 +1,387 @@
+#include "table_consumer.hpp"
+#include "kv_table.hpp"
+#include "crc32c.hpp"
+#include "util.hpp"
+#include <librdkafka/rdkafka.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mykafka {
+
+namespace {
+
+// Arquivo: [magic 8][crc32c u32][reservado u32][tamanho do corpo u64] e o corpo:
+// [n u32] n × ([tamanho u16][tópico][partição i32][offset i64]) e a KvTable
+constexpr char kMagic[8] = {'M', 'K', 'T', 'A', 'B', 'L', 'E', '1'};
+constexpr size_t kHeaderSize = 24;
+
+template <typename T> char* put_field(char* p, T v) {
+    std::memcpy(p, &v, sizeof(T));
+    return p + sizeof(T);
+}
+
+template <typename T> bool read_field(const char*& p, const char* end, T& v) {
+    if (static_cast<size_t>(end - p) < sizeof(T))
+        return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+class TableConsumer::Impl {
+public:
+    static int64_t now_ticks() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+    using Key = std::pair<std::string, int32_t>; // tópico, partição
+
+    rd_kafka_t* rk = nullptr;
+    rd_kafka_queue_t* queue = nullptr;
+    TableOptions options;
+
+    // tabela e posições andam juntas: o snapshot grava as duas de forma consistente
+    mutable std::shared_mutex mutex;
+    KvTable table;
+    std::map<Key, int64_t> positions; // próximo offset a aplicar
+    uint64_t version = 0;             // mensagens aplicadas desde a abertura
+
+    std::mutex snapshot_mutex;        // um snapshot por vez
+    uint64_t snapshot_version = 0;
+    // ticks do steady_clock: gravado no write_snapshot (sob snapshot_mutex), lido no poll sem lock
+    std::atomic<int64_t> last_snapshot{now_ticks()};
+    size_t restored_keys = 0;
+
+    std::set<Key> not_at_end;         // partições que ainda não deram EOF
+    std::atomic<bool> at_end{false};
+
+    std::vector<rd_kafka_message_t*> raw; // reaproveitado entre polls
+    // última partição vista: lotes costumam vir em sequência da mesma
+    const rd_kafka_topic_t* last_rkt = nullptr;
+    int32_t last_partition = -1;
+    int64_t* last_position = nullptr;
+
+    Impl(const ClientConfig& config, const std::vector<std::string>& topics, const TableOptions& opts)
+        : options(opts), table(opts.initial_slots)
+    {
+        char errstr[512];
+        if (options.max_batch == 0)
+            options.max_batch = 1;
+
+        // sem subscribe não há grupo; a posição vem do snapshot, nunca de commit
+        ClientConfig effective = config;
+        if (effective.get("group.id").empty())
+            effective.group_id("mykafka-table");
+        effective.set("enable.auto.commit", "false", ClientConfig::Scope::Consumer)
+                 .set("enable.auto.offset.store", "false", ClientConfig::Scope::Consumer)
+                 .set("enable.partition.eof", "true", ClientConfig::Scope::Consumer)
+                 .auto_offset_reset("earliest");
+
+        rd_kafka_conf_t* conf = rd_kafka_conf_new();
+        try {
+            effective.apply(conf, ClientConfig::Scope::Consumer);
+        } catch (...) {
+            rd_kafka_conf_destroy(conf);
+            throw;
+        }
+        rk = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
+        if (!rk)
+            throw std::runtime_error(std::string("Erro criando consumer da tabela: ") + errstr);
+
+        try {
+            if (!options.snapshot_path.empty())
+                load_snapshot();
+            assign(topics);
+        } catch (...) {
+            rd_kafka_destroy(rk);
+            throw;
+        }
+        queue = rd_kafka_queue_get_consumer(rk);
+    }
+
+    ~Impl() {
+        if (!options.snapshot_path.empty()) {
+            try {
+                write_snapshot(false);
+            } catch (const std::exception& e) {
+                std::cerr << "Erro no último snapshot: " << e.what() << std::endl;
+            }
+        }
+        rd_kafka_queue_destroy(queue);
+        rd_kafka_consumer_close(rk);
+        rd_kafka_destroy(rk);
+    }
+
+    // Todas as partições, do offset do snapshot ou do início
+    void assign(const std::vector<std::string>& topics) {
+        rd_kafka_topic_partition_list_t* list = rd_kafka_topic_partition_list_new(0);
+        try {
+            for (const std::string& topic : topics) {
+                for (int32_t p : topic_partitions(rk, topic, 10000)) {
+                    auto it = positions.find({topic, p});
+                    rd_kafka_topic_partition_list_add(list, topic.c_str(), p)->offset =
+                        it != positions.end() ? it->second : RD_KAFKA_OFFSET_BEGINNING;
+                    not_at_end.insert({topic, p});
+                }
+            }
+        } catch (...) {
+            rd_kafka_topic_partition_list_destroy(list);
+            throw;
+        }
+        rd_kafka_resp_err_t err = rd_kafka_assign(rk, list);
+        rd_kafka_topic_partition_list_destroy(list);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+            throw std::runtime_error(std::string("Erro no assign da tabela: ") + rd_kafka_err2str(err));
+        at_end = not_at_end.empty();
+    }
+
+    int64_t* position_of(const rd_kafka_message_t* msg) {
+        if (msg->rkt != last_rkt || msg->partition != last_partition) {
+            last_rkt = msg->rkt;
+            last_partition = msg->partition;
+            last_position = &positions[{rd_kafka_topic_name(msg->rkt), msg->partition}];
+        }
+        return last_position;
+    }
+
+    size_t poll(int timeout_ms) {
+        raw.resize(options.max_batch);
+        ssize_t n = rd_kafka_consume_batch_queue(queue, timeout_ms, raw.data(), raw.size());
+        if (n < 0) {
+            std::cerr << "Erro ao consumir lote da tabela: "
+                      << rd_kafka_err2str(rd_kafka_last_error()) << std::endl;
+            n = 0;
+        }
+
+        size_t applied = 0;
+        {
+            // um lock exclusivo por lote: as leituras esperam só o tempo de aplicá-lo
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            for (ssize_t i = 0; i < n; ++i) {
+                const rd_kafka_message_t* msg = raw[i];
+                if (msg->err != RD_KAFKA_RESP_ERR_NO_ERROR)
+                    continue;
+                *position_of(msg) = msg->offset + 1;
+                ++version;
+                if (!msg->key)
+                    continue;
+                std::string_view key(static_cast<const char*>(msg->key), msg->key_len);
+                if (msg->payload)
+                    table.put(key, std::string_view(static_cast<const char*>(msg->payload), msg->len));
+                else
+                    table.erase(key);
+                ++applied;
+            }
+        }
+
+        for (ssize_t i = 0; i < n; ++i) {
+            rd_kafka_message_t* msg = raw[i];
+            if (msg->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+                if (!at_end.load(std::memory_order_relaxed) && msg->rkt &&
+                    not_at_end.erase({rd_kafka_topic_name(msg->rkt), msg->partition}) > 0 &&
+                    not_at_end.empty())
+                    at_end = true;
+            } else if (msg->err != RD_KAFKA_RESP_ERR_NO_ERROR &&
+                       msg->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+                std::cerr << "Erro ao consumir: " << rd_kafka_message_errstr(msg) << std::endl;
+            }
+            rd_kafka_message_destroy(msg);
+        }
+
+        if (!options.snapshot_path.empty() &&
+            std::chrono::steady_clock::duration(now_ticks() - last_snapshot.load()) >=
+                std::chrono::milliseconds(options.snapshot_interval_ms)) {
+            try {
+                write_snapshot(false);
+            } catch (const std::exception& e) {
+                std::cerr << "Erro no snapshot: " << e.what() << std::endl;
+            }
+        }
+        return applied;
+    }
+
+    // Serializa sob lock compartilhado (as leituras continuam; o poll espera)
+    // num arquivo temporário mapeado em memória e troca pelo atual com rename
+    void write_snapshot(bool force) {
+        std::lock_guard<std::mutex> guard(snapshot_mutex);
+        last_snapshot = now_ticks();
+        const std::string& path = options.snapshot_path;
+        const std::string tmp = path + ".tmp";
+
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (!force && version == snapshot_version)
+            return;
+
+        size_t body = 4 + table.serialized_size();
+        for (const auto& [key, offset] : positions)
+            body += 2 + key.first.size() + 4 + 8;
+        size_t total = kHeaderSize + body;
+
+        int fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throw std::runtime_error(errno_text("Erro criando snapshot", tmp));
+        // reserva os blocos antes: disco cheio vira erro aqui, e não SIGBUS no memcpy
+        int err = posix_fallocate(fd, 0, static_cast<off_t>(total));
+        void* base = err == 0 ? mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (base == MAP_FAILED) {
+            if (err != 0)
+                errno = err;
+            std::string what = errno_text("Erro gravando snapshot", tmp);
+            close(fd);
+            unlink(tmp.c_str());
+            throw std::runtime_error(what);
+        }
+
+        char* p = static_cast<char*>(base) + kHeaderSize;
+        p = put_field<uint32_t>(p, static_cast<uint32_t>(positions.size()));
+        for (const auto& [key, offset] : positions) {
+            p = put_field<uint16_t>(p, static_cast<uint16_t>(key.first.size()));
+            std::memcpy(p, key.first.data(), key.first.size());
+            p += key.first.size();
+            p = put_field<int32_t>(p, key.second);
+            p = put_field<int64_t>(p, offset);
+        }
+        table.serialize(p);
+        snapshot_version = version;
+        lock.unlock();
+
+        char* header = static_cast<char*>(base);
+        std::memcpy(header, kMagic, sizeof(kMagic));
+        put_field<uint32_t>(header + 8, crc32c(header + kHeaderSize, body));
+        put_field<uint32_t>(header + 12, 0);
+        put_field<uint64_t>(header + 16, body);
+
+        bool synced = msync(base, total, MS_SYNC) == 0;
+        std::string what = synced ? "" : errno_text("Erro gravando snapshot", tmp);
+        munmap(base, total);
+        close(fd);
+        if (synced && rename(tmp.c_str(), path.c_str()) != 0)
+            what = errno_text("Erro trocando snapshot", path);
+        if (!what.empty()) {
+            unlink(tmp.c_str());
+            throw std::runtime_error(what);
+        }
+    }
+
+    void load_snapshot() {
+        const std::string& path = options.snapshot_path;
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno != ENOENT)
+                std::cerr << errno_text("Erro abrindo snapshot", path) << std::endl;
+            return;
+        }
+        struct stat st;
+        size_t size = fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        void* base = size >= kHeaderSize ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+
+        bool ok = base != MAP_FAILED && parse_snapshot(static_cast<const char*>(base), size);
+        if (base != MAP_FAILED)
+            munmap(base, size);
+        if (!ok) {
+            std::cerr << "Snapshot inválido ignorado, lendo desde o início: " << path << std::endl;
+            positions.clear();
+            table = KvTable(options.initial_slots);
+            return;
+        }
+        restored_keys = table.size();
+    }
+
+    bool parse_snapshot(const char* data, size_t size) {
+        uint32_t crc;
+        uint64_t body;
+        std::memcpy(&crc, data + 8, 4);
+        std::memcpy(&body, data + 16, 8);
+        if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0 || body != size - kHeaderSize ||
+            crc32c(data + kHeaderSize, body) != crc)
+            return false;
+
+        const char* p = data + kHeaderSize;
+        const char* end = data + size;
+        uint32_t count;
+        if (!read_field(p, end, count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint16_t len;
+            int32_t partition;
+            int64_t offset;
+            if (!read_field(p, end, len) || static_cast<size_t>(end - p) < len)
+                return false;
+            std::string topic(p, len);
+            p += len;
+            if (!read_field(p, end, partition) || !read_field(p, end, offset))
+                return false;
+            positions[{std::move(topic), partition}] = offset;
+        }
+        return table.deserialize(p, static_cast<size_t>(end - p));
+    }
+};
+
+TableConsumer::TableConsumer(const ClientConfig& config, const std::vector<std::string>& topics,
+                             const TableOptions& options)
+    : impl_(std::make_unique<Impl>(config, topics, options))
+{
+}
+
+TableConsumer::~TableConsumer() = default;
+
+size_t TableConsumer::poll(int timeout_ms) {
+    return impl_->poll(timeout_ms);
+}
+
+bool TableConsumer::caught_up() const {
+    return impl_->at_end.load();
+}
+
+std::optional<std::string> TableConsumer::get(std::string_view key) const {
+    std::string value;
+    if (!get(key, value))
+        return std::nullopt;
+    return value;
+}
+
+bool TableConsumer::get(std::string_view key, std::string& value) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->table.get(key, value);
+}
+
+bool TableConsumer::contains(std::string_view key) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->table.contains(key);
+}
+
+size_t TableConsumer::size() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->table.size();
+}
+
+size_t TableConsumer::memory_bytes() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->table.memory_bytes();
+}
+
+void TableConsumer::snapshot() {
+    if (impl_->options.snapshot_path.empty())
+        throw std::runtime_error("snapshot() requer TableOptions::snapshot_path");
+    impl_->write_snapshot(true);
+}
+
+size_t TableConsumer::restored() const {
+    return impl_->restored_keys;
+}
+
+} // namespace mykafka
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <librdkafka/rdkafka.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mykafka {
+
+// Auxiliares internos usados pelo spill, pela tabela e pelo replay
+
+// "<what> <path>: <strerror(errno)>"; chame logo depois da falha, antes de
+// qualquer coisa que possa mudar o errno
+inline std::string errno_text(const std::string& what, const std::string& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+
+// Partições de um tópico pelos metadados, em ordem crescente
+inline std::vector<int32_t> topic_partitions(rd_kafka_t* rk, const std::string& topic, int timeout_ms) {
+    rd_kafka_topic_t* rkt = rd_kafka_topic_new(rk, topic.c_str(), nullptr);
+    const rd_kafka_metadata_t* md = nullptr;
+    rd_kafka_resp_err_t err = rd_kafka_metadata(rk, 0, rkt, &md, timeout_ms);
+    rd_kafka_topic_destroy(rkt);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+        throw std::runtime_error("Erro lendo metadados de " + topic + ": " + rd_kafka_err2str(err));
+
+    std::vector<int32_t> partitions;
+    err = md->topic_cnt > 0 ? md->topics[0].err : RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART;
+    if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+        for (int i = 0; i < md->topics[0].partition_cnt; ++i)
+            partitions.push_back(md->topics[0].partitions[i].id);
+    }
+    rd_kafka_metadata_destroy(md);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR)
+        throw std::runtime_error("Erro lendo metadados de " + topic + ": " + rd_kafka_err2str(err));
+
+    std::sort(partitions.begin(), partitions.end());
+    return partitions;
+}
+
+} // namespace mykafka